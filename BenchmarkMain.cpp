@@ -0,0 +1,8 @@
+#include "Benchmarks.hpp"
+
+// Entry point for the "CodeRedBenchmarks" console target, kept out of the overlay since the benchmarks clear the shared name tables between runs.
+int main()
+{
+	ImBenchmarks::RunAll();
+	return 0;
+}
@@ -0,0 +1,499 @@
+#include "Benchmarks.hpp"
+
+namespace ImBenchmarks
+{
+	BenchmarkResult::BenchmarkResult(const std::string& name, size_t size, size_t operations, double nanoseconds, double bytes) :
+		Name(name),
+		Size(size),
+		Operations(operations),
+		NanosecondsPerOp(nanoseconds),
+		BytesPerOp(bytes)
+	{
+
+	}
+
+	BenchmarkResult::~BenchmarkResult() {}
+
+	SyntheticEventSource::SyntheticEventSource(size_t events, int32_t functions, int32_t callers, int32_t packages, double exponent, uint32_t seed) :
+		Position(0),
+		Remaining(events),
+		FunctionCount(std::max(functions, 1)),
+		CallerCount(std::max(callers, 1)),
+		PackageCount(std::max(packages, 1))
+	{
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<double> uniform(0.0, 1.0);
+		std::vector<double> functionTable = ZipfTable(static_cast<size_t>(FunctionCount), exponent);
+		std::vector<double> callerTable = ZipfTable(static_cast<size_t>(CallerCount), exponent);
+
+		// Popularity rank and object index are shuffled apart, otherwise the hottest functions would all sit next to each other.
+		std::vector<int32_t> functionOrder(static_cast<size_t>(FunctionCount));
+		std::vector<int32_t> callerOrder(static_cast<size_t>(CallerCount));
+		for (int32_t i = 0; i < FunctionCount; i++) { functionOrder[i] = i; }
+		for (int32_t i = 0; i < CallerCount; i++) { callerOrder[i] = i; }
+		std::shuffle(functionOrder.begin(), functionOrder.end(), random);
+		std::shuffle(callerOrder.begin(), callerOrder.end(), random);
+
+		Events.resize(1 << 20);
+
+		for (ImClasses::SourceEvent& sourceEvent : Events)
+		{
+			size_t functionRank = static_cast<size_t>(std::upper_bound(functionTable.begin(), functionTable.end(), uniform(random)) - functionTable.begin());
+			size_t callerRank = static_cast<size_t>(std::upper_bound(callerTable.begin(), callerTable.end(), uniform(random)) - callerTable.begin());
+			sourceEvent.Function = functionOrder[std::min(functionRank, (functionOrder.size() - 1))];
+			sourceEvent.Caller = (FunctionCount + callerOrder[std::min(callerRank, (callerOrder.size() - 1))]);
+			sourceEvent.Package = (FunctionCount + CallerCount + (sourceEvent.Function % PackageCount));
+		}
+	}
+
+	SyntheticEventSource::~SyntheticEventSource() {}
+
+	bool SyntheticEventSource::Next(ImClasses::SourceEvent& sourceEvent)
+	{
+		if (Remaining == 0)
+		{
+			return false;
+		}
+
+		sourceEvent = Events[Position];
+		Position = ((Position + 1) & (Events.size() - 1));
+		Remaining--;
+		return true;
+	}
+
+	std::string SyntheticEventSource::GetFullName(int32_t functionIndex) const
+	{
+		int32_t package = (functionIndex % PackageCount);
+		return ("Function Package" + std::to_string(package) + ".Class" + std::to_string(functionIndex % 97) + ".Function" + std::to_string(functionIndex));
+	}
+
+	std::string SyntheticEventSource::GetObjectName(int32_t objectIndex) const
+	{
+		if (objectIndex < FunctionCount)
+		{
+			return ("Function" + std::to_string(objectIndex));
+		}
+		else if (objectIndex < (FunctionCount + CallerCount))
+		{
+			return ("Caller_" + std::to_string(objectIndex - FunctionCount));
+		}
+
+		return ("Package" + std::to_string(objectIndex - FunctionCount - CallerCount));
+	}
+
+	void SyntheticEventSource::Reset(size_t events)
+	{
+		Position = 0;
+		Remaining = events;
+	}
+
+	std::vector<double> SyntheticEventSource::ZipfTable(size_t count, double exponent)
+	{
+		// Cumulative distribution where rank "k" is picked proportionally to 1 / k^exponent.
+		std::vector<double> table(count);
+		double total = 0.0;
+
+		for (size_t i = 0; i < count; i++)
+		{
+			total += (1.0 / std::pow(static_cast<double>(i + 1), exponent));
+			table[i] = total;
+		}
+
+		for (double& value : table)
+		{
+			value /= total;
+		}
+
+		return table;
+	}
+
+	static double ElapsedNanoseconds(std::chrono::steady_clock::time_point start)
+	{
+		return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+	}
+
+	std::vector<BenchmarkResult> DedupIndex(size_t events)
+	{
+		std::vector<BenchmarkResult> results;
+
+		for (size_t distinct : { 100, 1000, 10000, 100000 })
+		{
+			// Object indices are sparse in a real game, so spread the keys out and visit them in a shuffled order.
+			std::vector<int32_t> keys(1 << 20);
+			uint32_t seed = 0x12345678;
+
+			for (int32_t& key : keys)
+			{
+				seed ^= (seed << 13); seed ^= (seed >> 17); seed ^= (seed << 5);
+				key = static_cast<int32_t>((seed % distinct) * 37);
+			}
+
+			ImClasses::IndexMap slots;
+			std::vector<size_t> calls;
+
+			// Warm up so every distinct key has its row, the timed loop then measures the steady state per-event cost.
+			for (size_t i = 0; i < keys.size(); i++)
+			{
+				bool inserted = false;
+				uint32_t slot = slots.FindOrInsert(keys[i], static_cast<uint32_t>(calls.size()), inserted);
+				if (inserted) { calls.push_back(0); }
+				calls[slot]++;
+			}
+
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+			for (size_t i = 0; i < events; i++)
+			{
+				bool inserted = false;
+				uint32_t slot = slots.FindOrInsert(keys[i & (keys.size() - 1)], static_cast<uint32_t>(calls.size()), inserted);
+				if (inserted) { calls.push_back(0); }
+				calls[slot]++;
+			}
+
+			double elapsed = ElapsedNanoseconds(start);
+			results.emplace_back("Dedup (IndexMap)", distinct, events, (elapsed / events), (static_cast<double>(slots.GetBytes()) / distinct));
+		}
+
+		return results;
+	}
+
+	std::vector<BenchmarkResult> FilterMatch(size_t names)
+	{
+		std::vector<BenchmarkResult> results;
+		SyntheticEventSource source(0, 100000, 1, 200);
+		std::vector<std::string> fullNames(4096);
+
+		for (size_t i = 0; i < fullNames.size(); i++)
+		{
+			fullNames[i] = source.GetFullName(static_cast<int32_t>((i * 7919) % 100000));
+		}
+
+		for (size_t termCount : { 1, 4, 16, 24 }) // 24 is about as many as fit in "ImGuiTextFilter::InputBuf".
+		{
+			ImGuiTextFilter whitelist;
+			ImGuiTextFilter blacklist;
+			std::string whitelistText;
+			std::string blacklistText;
+
+			// Mostly includes with a few excludes mixed in, the same shape as a hand written filter list.
+			for (size_t i = 0; i < termCount; i++)
+			{
+				whitelistText += (((i % 4) == 3) ? ("-Class" + std::to_string(i) + ".") : ("tion" + std::to_string(i * 13))) + ",";
+				blacklistText += ("age" + std::to_string(i * 5) + ".,");
+			}
+
+			strcpy_s(whitelist.InputBuf, sizeof(whitelist.InputBuf), whitelistText.substr(0, (sizeof(whitelist.InputBuf) - 1)).c_str());
+			strcpy_s(blacklist.InputBuf, sizeof(blacklist.InputBuf), blacklistText.substr(0, (sizeof(blacklist.InputBuf) - 1)).c_str());
+			whitelist.Build();
+			blacklist.Build();
+
+			ImClasses::TextMatcher matcher;
+			matcher.Compile({ &whitelist, &blacklist });
+
+			// What "ImFunctionScanner::PassesFilter" did before the filters were compiled.
+			auto passesFilters = [&](const std::string& text) {
+				return ((!whitelist.IsActive() || whitelist.PassFilter(text.c_str())) && !(blacklist.IsActive() && blacklist.PassFilter(text.c_str())));
+			};
+
+			size_t expected = 0;
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+			for (size_t i = 0; i < names; i++)
+			{
+				expected += (passesFilters(fullNames[i & (fullNames.size() - 1)]) ? 1 : 0);
+			}
+
+			double elapsed = ElapsedNanoseconds(start);
+			results.emplace_back("Filter (ImGuiTextFilter)", termCount, expected, (elapsed / names), 0.0);
+
+			size_t passed = 0;
+			start = std::chrono::steady_clock::now();
+
+			for (size_t i = 0; i < names; i++)
+			{
+				const std::string& text = fullNames[i & (fullNames.size() - 1)];
+				uint32_t mask = matcher.Match(text.data(), text.size());
+				passed += (((mask & 1) && !(blacklist.IsActive() && (mask & 2))) ? 1 : 0);
+			}
+
+			elapsed = ElapsedNanoseconds(start);
+			IM_ASSERT((passed == expected) && "TextMatcher disagrees with ImGuiTextFilter.");
+			results.emplace_back("Filter (TextMatcher)", termCount, passed, (elapsed / names), static_cast<double>(matcher.GetBytes()));
+		}
+
+		return results;
+	}
+
+	std::vector<BenchmarkResult> ScannerPipeline(size_t maxEvents)
+	{
+		std::vector<BenchmarkResult> results;
+		SyntheticEventSource source(0, 10000, 2000, 200);
+		ImClasses::SourceEvent sourceEvent;
+
+		for (size_t events = 1000000; events <= maxEvents; events *= 10)
+		{
+			// Capture, what the game thread pays per call. The pointers are left null since only the clock read and slot traffic are being measured.
+			{
+				ImClasses::EventRing<ImClasses::FunctionEvent> ring;
+				ring.Reserve(65536);
+				size_t drained = 0;
+				source.Reset(events);
+
+				std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+				while (source.Next(sourceEvent))
+				{
+					if (!ring.Push(ImClasses::FunctionEvent(nullptr, nullptr, sourceEvent.Function, sourceEvent.Caller, 0, 0, ImClasses::EventClock::Now(), 0, 1)))
+					{
+						drained += ring.Drain([](const ImClasses::FunctionEvent&) {}, ring.GetCapacity());
+						ring.Push(ImClasses::FunctionEvent(nullptr, nullptr, sourceEvent.Function, sourceEvent.Caller, 0, 0, ImClasses::EventClock::Now(), 0, 1));
+					}
+				}
+
+				drained += ring.Drain([](const ImClasses::FunctionEvent&) {}, ring.GetCapacity());
+				double elapsed = ElapsedNanoseconds(start);
+				results.emplace_back("Capture (clock + ring)", events, drained, (elapsed / events), static_cast<double>(sizeof(ImClasses::FunctionEvent)));
+			}
+
+			// Filter and dedup, run through a real scanner so it's the same code "DrainEvents" calls. Nothing here touches the ImGui context.
+			// Clearing the names is only safe because this runs in its own process, see "BenchmarkMain.cpp".
+			ImClasses::FunctionData::ClearNames();
+			ImFunctionScanner scanner("Benchmark", "Benchmark", nullptr, false);
+			scanner.OnAttach();
+			scanner.SetFilters("Function", "Class13.");
+
+			{
+				size_t passed = 0;
+				source.Reset(events);
+
+				std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+				while (source.Next(sourceEvent))
+				{
+					ImClasses::FunctionData newEntry(source, sourceEvent);
+					passed += (scanner.PassesFilter(newEntry) ? 1 : 0);
+				}
+
+				double elapsed = ElapsedNanoseconds(start);
+				results.emplace_back("Resolve + filter", events, passed, (elapsed / events), (static_cast<double>(ImClasses::FunctionData::FullNames.GetBytes() + ImClasses::FunctionData::ObjectNames.GetBytes()) / events));
+			}
+
+			{
+				source.Reset(events);
+				std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+				while (source.Next(sourceEvent))
+				{
+					ImClasses::FunctionData newEntry(source, sourceEvent);
+
+					if (scanner.PassesFilter(newEntry))
+					{
+						scanner.AddEvent(newEntry, 0, 1, false);
+					}
+				}
+
+				double elapsed = ElapsedNanoseconds(start);
+				results.emplace_back("Resolve + filter + dedup", events, events, (elapsed / events), (static_cast<double>(scanner.GetMemoryUsage()) / events));
+			}
+
+			scanner.ClearTable();
+		}
+
+		return results;
+	}
+
+	std::vector<BenchmarkResult> ConsoleAppend(size_t lines)
+	{
+		std::vector<BenchmarkResult> results;
+		std::vector<std::string> logLines(1024);
+
+		for (size_t i = 0; i < logLines.size(); i++)
+		{
+			logLines[i] = ("[Log] Loaded package Package" + std::to_string(i) + " in " + std::to_string(i * 3) + "ms.");
+		}
+
+		for (size_t historySize : { 256, 1024, 5120 })
+		{
+			// What "ImTerminal::AddDisplayText" did before the ring, every line once full shifts the whole history down by one.
+			{
+				std::vector<ImClasses::TextData> consoleText;
+				size_t shiftLines = std::min<size_t>(lines, 20000); // Quadratic, so only a slice of the lines to keep the run short.
+
+				for (size_t i = 0; i < historySize; i++)
+				{
+					consoleText.emplace_back(logLines[i & (logLines.size() - 1)], TextColors::White, TextStyles::Regular);
+				}
+
+				std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+				for (size_t i = 0; i < shiftLines; i++)
+				{
+					ImClasses::TextData newData(logLines[i & (logLines.size() - 1)], TextColors::White, TextStyles::Regular);
+
+					for (size_t j = 1; j < consoleText.size(); j++)
+					{
+						consoleText[j - 1] = consoleText[j];
+					}
+
+					consoleText[consoleText.size() - 1] = newData;
+				}
+
+				double elapsed = ElapsedNanoseconds(start);
+				results.emplace_back("Console append (shift)", historySize, shiftLines, (elapsed / shiftLines), 0.0);
+			}
+
+			// The terminal's own queue and log types, filled up first so every timed line evicts one. Standalone copies, so the live console is never touched.
+			// Includes the trip through the logging queue, drained the same way "ImTerminal::DrainQueue" does as often as a frame would.
+			{
+				ImClasses::EventRing<ImClasses::QueueData> consoleQueue(8192);
+				ImClasses::TextLog consoleText;
+				consoleText.SetCapacity(historySize);
+
+				auto drainQueue = [&]() {
+					consoleQueue.Drain([&](const ImClasses::QueueData& queueData) {
+						consoleText.Push(queueData.Text, queueData.Id, queueData.Style);
+					}, consoleQueue.GetCapacity());
+				};
+
+				for (size_t i = 0; i < historySize; i++)
+				{
+					consoleText.Push(logLines[i & (logLines.size() - 1)], TextColors::White, TextStyles::Regular);
+				}
+
+				std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+				for (size_t i = 0; i < lines; i++)
+				{
+					consoleQueue.Push(ImClasses::QueueData(logLines[i & (logLines.size() - 1)], TextColors::White, TextStyles::Regular));
+					if ((i & 4095) == 4095) { drainQueue(); }
+				}
+
+				drainQueue();
+
+				double elapsed = ElapsedNanoseconds(start);
+				results.emplace_back("Console append (queue + ring)", historySize, lines, (elapsed / lines), (static_cast<double>(consoleText.GetBytes()) / historySize));
+			}
+		}
+
+		return results;
+	}
+
+	std::vector<BenchmarkResult> CompletionLookup(size_t words)
+	{
+		std::vector<BenchmarkResult> results;
+		std::vector<std::string> typedWords = { "Function1234", "caller_777", "Package12.Class40", "FUNCTION99" };
+		std::vector<std::string> fuzzyWords = { "fn1234", "cllr77", "pkg12cls40fn", "clss3.fun" };
+
+		for (size_t wordCount : { (words / 100), (words / 10), words })
+		{
+			// Half function names, a quarter caller names, and a quarter full names without the "Function " prefix, about what a game registers once its object names are added as arguments.
+			SyntheticEventSource source(0, static_cast<int32_t>(wordCount / 2), static_cast<int32_t>(wordCount / 4), 200);
+			std::vector<std::string> completeWords(wordCount);
+
+			for (size_t i = 0; i < wordCount; i++)
+			{
+				int32_t index = static_cast<int32_t>(i);
+				completeWords[i] = ((i < ((wordCount * 3) / 4)) ? source.GetObjectName(index) : source.GetFullName(index).substr(9));
+			}
+
+			ImClasses::CompletionIndex completes;
+			std::vector<const std::string*> found;
+			std::vector<std::pair<std::string, bool>> candidates;
+
+			for (const std::string& word : completeWords)
+			{
+				completes.Add(word);
+			}
+
+			completes.FindPrefix("", 0, 0, found); // Sorts once up front, same as the first keystroke after registering would.
+
+			// What "ImTerminal::TextEditCallback" did before the index, every keystroke compares against every word and copies out every match.
+			{
+				size_t keystrokes = 0;
+				std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+				for (const std::string& typed : typedWords)
+				{
+					for (size_t length = 1; length <= typed.size(); length++, keystrokes++)
+					{
+						candidates.clear();
+
+						for (const std::string& word : completeWords)
+						{
+							if (ImExtensions::Strnicmp(word.c_str(), typed.c_str(), static_cast<int32_t>(length)) == 0)
+							{
+								candidates.emplace_back(word, candidates.empty());
+							}
+						}
+					}
+				}
+
+				double elapsed = ElapsedNanoseconds(start);
+				results.emplace_back("Completion (linear)", wordCount, keystrokes, (elapsed / keystrokes), 0.0);
+			}
+
+			{
+				size_t keystrokes = 0;
+				std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+				for (const std::string& typed : typedWords)
+				{
+					for (size_t length = 1; length <= typed.size(); length++, keystrokes++)
+					{
+						candidates.clear();
+						completes.FindPrefix(typed.c_str(), length, ImTerminal::MaxCandidates, found);
+						for (size_t i = 0; i < found.size(); i++) { candidates.emplace_back(*found[i], (i == 0)); }
+					}
+				}
+
+				double elapsed = ElapsedNanoseconds(start);
+				results.emplace_back("Completion (prefix index)", wordCount, keystrokes, (elapsed / keystrokes), (static_cast<double>(completes.GetBytes()) / wordCount));
+			}
+
+			// Typed one character at a time like the terminal sees it, each word starts over from an empty pattern.
+			{
+				size_t keystrokes = 0;
+				std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+				for (const std::string& typed : fuzzyWords)
+				{
+					for (size_t length = 1; length <= typed.size(); length++, keystrokes++)
+					{
+						candidates.clear();
+						completes.FindFuzzy(typed.c_str(), length, ImTerminal::MaxCandidates, found);
+						for (size_t i = 0; i < found.size(); i++) { candidates.emplace_back(*found[i], (i == 0)); }
+					}
+				}
+
+				double elapsed = ElapsedNanoseconds(start);
+				results.emplace_back("Completion (fuzzy)", wordCount, keystrokes, (elapsed / keystrokes), (static_cast<double>(completes.GetBytes()) / wordCount));
+			}
+		}
+
+		return results;
+	}
+
+	void PrintResults(const std::vector<BenchmarkResult>& results)
+	{
+		for (const BenchmarkResult& result : results)
+		{
+			std::cout << std::left << std::setw(32) << result.Name
+				<< " n=" << std::setw(10) << result.Size
+				<< " ops=" << std::setw(12) << result.Operations
+				<< std::fixed << std::setprecision(2)
+				<< " ns/op=" << std::setw(10) << result.NanosecondsPerOp
+				<< " bytes=" << result.BytesPerOp << "\n";
+		}
+
+		std::cout.flush();
+	}
+
+	void RunAll()
+	{
+		PrintResults(DedupIndex());
+		PrintResults(FilterMatch());
+		PrintResults(ScannerPipeline());
+		PrintResults(ConsoleAppend());
+		PrintResults(CompletionLookup());
+	}
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include "CodeRed.hpp"
+
+// Headless benchmarks for the scanner and terminal data structures, no ImGui context or game SDK is needed to run these.
+// Only built into the "CodeRedBenchmarks" console target, "ScannerPipeline" clears "FunctionData"'s name tables which a live scanner in the same process would still be using.
+namespace ImBenchmarks
+{
+	class BenchmarkResult
+	{
+	public:
+		std::string Name;
+		size_t Size; // Input size the benchmark was run at (distinct functions, history length, etc).
+		size_t Operations;
+		double NanosecondsPerOp;
+		double BytesPerOp;
+
+	public:
+		BenchmarkResult(const std::string& name, size_t size, size_t operations, double nanoseconds, double bytes);
+		~BenchmarkResult();
+	};
+
+	// Replays Zipf distributed calls over a fixed set of made up functions, callers, and packages.
+	// Object indices are laid out functions first, then callers, then packages, so they never collide just like in the real object array.
+	class SyntheticEventSource : public ImClasses::EventSource
+	{
+	private:
+		std::vector<ImClasses::SourceEvent> Events; // Drawn once up front and replayed in a loop, so generating them never shows up in a measurement.
+		size_t Position;
+		size_t Remaining;
+		int32_t FunctionCount;
+		int32_t CallerCount;
+		int32_t PackageCount;
+
+	public:
+		SyntheticEventSource(size_t events, int32_t functions, int32_t callers, int32_t packages, double exponent = 1.0, uint32_t seed = 0x5EED);
+		~SyntheticEventSource() override;
+
+	public:
+		bool Next(ImClasses::SourceEvent& sourceEvent) override;
+		std::string GetFullName(int32_t functionIndex) const override;
+		std::string GetObjectName(int32_t objectIndex) const override;
+		void Reset(size_t events); // Rewinds to the start of the same sequence.
+
+	private:
+		static std::vector<double> ZipfTable(size_t count, double exponent);
+	};
+
+	std::vector<BenchmarkResult> DedupIndex(size_t events = 10000000);
+	std::vector<BenchmarkResult> FilterMatch(size_t names = 10000000); // "ImGuiTextFilter" pairs against the compiled "TextMatcher" at 1 to 24 terms.
+	std::vector<BenchmarkResult> ScannerPipeline(size_t maxEvents = 100000000); // Capture, filter, and dedup paths at 1M, 10M, and 100M events.
+	std::vector<BenchmarkResult> ConsoleAppend(size_t lines = 1000000); // Appending to a full terminal history at 256 to 5120 lines, against the old shift-everything approach.
+	std::vector<BenchmarkResult> CompletionLookup(size_t words = 100000); // Terminal autocomplete per keystroke at 1K to 100K words, the old linear "Strnicmp" pass against the prefix and fuzzy index.
+
+	void PrintResults(const std::vector<BenchmarkResult>& results);
+	void RunAll();
+}
@@ -2,7 +2,9 @@
 
 namespace ImClasses
 {
-	TextData::TextData(const std::string& text, TextColors textColor, TextStyles textStyle) : Text(text), Color(ImColorMap[textColor]), Style(textStyle) {}
+	TextData::TextData() : Color(1.0f, 1.0f, 1.0f, 1.0f), Style(TextStyles::Regular) {}
+
+	TextData::TextData(const std::string& text, TextColors textColor, TextStyles textStyle) : Text(text), Color(ImColorMap.at(textColor)), Style(textStyle) {} // Built on logging threads too, "at" never inserts so concurrent lookups are safe.
 
 	TextData::~TextData() {}
 
@@ -14,6 +16,8 @@ namespace ImClasses
 		return *this;
 	}
 
+	QueueData::QueueData() : Id(TextColors::White) {}
+
 	QueueData::QueueData(const std::string& text, TextColors textColor, TextStyles textStyle) : TextData(text, textColor, textStyle), Id(textColor) {}
 
 	QueueData::~QueueData() {}
@@ -27,770 +31,4888 @@ namespace ImClasses
 		return *this;
 	}
 
-	FunctionCount::FunctionCount() : Calls(0) {}
+	NameTable::NameTable() : StringBytes(0)
+	{
+		Clear();
+	}
 
-	FunctionCount::~FunctionCount() {}
+	NameTable::~NameTable() {}
 
-	FunctionData::FunctionData() :
-		FullName("null"),
-		Package("null"),
-		Caller("null"),
-		Function("null"),
-		Index(0)
+	uint32_t NameTable::Find(int32_t objectIndex, uint32_t generation) const
 	{
+		std::unordered_map<uint64_t, uint32_t>::const_iterator idIt = IndexIds.find(GetKey(objectIndex, generation));
+
+		if (idIt != IndexIds.end())
+		{
+			return idIt->second;
+		}
 
+		return NullId;
 	}
 
-	FunctionData::FunctionData(const FunctionData& functionData) :
-		FullName(functionData.FullName),
-		Package(functionData.Package),
-		Caller(functionData.Caller),
-		Function(functionData.Function),
-		Index(functionData.Index)
+	uint32_t NameTable::Intern(const std::string& name)
 	{
+		std::unordered_map<std::string_view, uint32_t>::const_iterator textIt = TextIds.find(name);
+
+		if (textIt != TextIds.end())
+		{
+			return textIt->second;
+		}
 
+		uint32_t id = static_cast<uint32_t>(Names.size());
+		Names.push_back(name);
+		TextIds.emplace(Names.back(), id);
+		StringBytes += name.capacity();
+		return id;
 	}
 
-	FunctionData::FunctionData(class UObject* caller, class UFunction* function) :
-		FullName("null"),
-		Package("null"),
-		Caller("null"),
-		Function("null"),
-		Index(0)
+	uint32_t NameTable::Intern(int32_t objectIndex, const std::string& name, uint32_t generation)
 	{
-		// Requires and actual SDK for your game, so that's why this is commented out.
-
-		//if (caller && function)
-		//{
-		//	FullName = function->GetFullName();
-		//	Package = function->GetPackageObj()->GetName();
-		//	Caller = caller->GetName();
-		//	Function = function->GetName();
-		//	Index = function->ObjectInternalInteger;
-		//}
+		uint32_t id = Intern(name);
+		IndexIds[GetKey(objectIndex, generation)] = id;
+		return id;
 	}
 
-	FunctionData::FunctionData(const std::string& fullName, const std::string& package, const std::string& caller, const std::string& function, int32_t index) :
-		FullName(fullName),
-		Package(package),
-		Caller(caller),
-		Function(function),
-		Index(index)
+	const std::string& NameTable::Get(uint32_t id) const
 	{
-
+		return ((id < Names.size()) ? Names[id] : Names[NullId]);
 	}
 
-	FunctionData::~FunctionData() {}
-
-	FunctionData& FunctionData::operator=(const FunctionData& functionData)
+	size_t NameTable::Size() const
 	{
-		FullName = functionData.FullName;
-		Package = functionData.Package;
-		Caller = functionData.Caller;
-		Function = functionData.Function;
-		Index = functionData.Index;
-		return *this;
+		return Names.size();
 	}
-}
-
-ImInterface::ImInterface(const std::string& title, const std::string& name, std::function<void(std::string, bool)> toggleCallback, bool bShowCursor) :
-	WindowTitle(title),
-	ShowCursor(bShowCursor),
-	WindowName(name),
-	Attached(false),
-	ToggleCallback(toggleCallback),
-	Render(false),
-	Focused(false)
-{
-
-}
-
-ImInterface::~ImInterface()
-{
-	OnDetatch();
-}
-
-const std::string& ImInterface::GetTitle() const
-{
-	return WindowTitle;
-}
-
-const std::string& ImInterface::GetName() const
-{
-	return WindowName;
-}
-
-bool ImInterface::ShouldShowCursor() const
-{
-	return ShowCursor;
-}
 
-bool ImInterface::IsAttached() const
-{
-	return Attached;
-}
+	size_t NameTable::GetBytes() const
+	{
+		return (StringBytes + (Names.size() * sizeof(std::string)));
+	}
 
-bool ImInterface::ShouldRender()
-{
-	if (!Render)
+	void NameTable::Clear()
 	{
-		SetShouldRender(false);
+		IndexIds.clear();
+		TextIds.clear();
+		Names.clear();
+		StringBytes = 0;
+		Intern("null");
 	}
 
-	return (IsAttached() && Render);
-}
+	uint64_t NameTable::GetKey(int32_t objectIndex, uint32_t generation)
+	{
+		return ((static_cast<uint64_t>(generation) << 32) | static_cast<uint32_t>(objectIndex));
+	}
 
-bool* ImInterface::ShouldBegin()
-{
-	return &Render;
-}
+	IndexMap::IndexMap() : Mask(0), Count(0) {}
 
-bool ImInterface::IsFocused() const
-{
-	return Focused;
-}
+	IndexMap::~IndexMap() {}
 
-void ImInterface::SetAttached(bool bAttached)
-{
-	Attached = bAttached;
-}
+	uint32_t IndexMap::Find(int32_t key) const
+	{
+		if (!Buckets.empty())
+		{
+			for (size_t i = (Hash(key) & Mask); ; i = ((i + 1) & Mask))
+			{
+				const Bucket& bucket = Buckets[i];
 
-void ImInterface::SetShouldRender(bool bShouldRender)
-{
-	Render = bShouldRender;
+				if (bucket.Slot == InvalidSlot)
+				{
+					break;
+				}
+				else if (bucket.Key == key)
+				{
+					return bucket.Slot;
+				}
+			}
+		}
 
-	if (ToggleCallback)
-	{
-		ToggleCallback(WindowName, Render);
+		return InvalidSlot;
 	}
-}
 
-void ImInterface::SetIsFocused(bool bFocused)
-{
-	Focused = bFocused;
-}
+	uint32_t IndexMap::FindOrInsert(int32_t key, uint32_t slot, bool& bInserted)
+	{
+		// Kept at or under half full, so probe sequences stay short and there is always an empty bucket to stop on.
+		if (((Count + 1) * 2) > Buckets.size())
+		{
+			Rehash(Buckets.empty() ? 64 : (Buckets.size() * 2));
+		}
 
-void ImInterface::ToggleRender()
-{
-	SetShouldRender(!Render);
-}
+		for (size_t i = (Hash(key) & Mask); ; i = ((i + 1) & Mask))
+		{
+			Bucket& bucket = Buckets[i];
 
-void ImInterface::OnAttach()
-{
-	SetAttached(true);
-}
+			if (bucket.Slot == InvalidSlot)
+			{
+				bucket.Key = key;
+				bucket.Slot = slot;
+				Count++;
+				bInserted = true;
+				return slot;
+			}
+			else if (bucket.Key == key)
+			{
+				bInserted = false;
+				return bucket.Slot;
+			}
+		}
+	}
 
-void ImInterface::OnDetatch()
-{
-	if (IsAttached())
+	size_t IndexMap::Size() const
 	{
-		SetAttached(false);
+		return Count;
 	}
-}
-
-void ImInterface::OnRender() {}
 
-ImDemo::ImDemo(const std::string& title, const std::string& name, std::function<void(std::string, bool)> toggleCallback, bool bShowCursor) : ImInterface(title, name, toggleCallback, bShowCursor) {}
+	size_t IndexMap::GetBytes() const
+	{
+		return (Buckets.capacity() * sizeof(Bucket));
+	}
 
-ImDemo::~ImDemo()
-{
-	OnDetatch();
-}
+	void IndexMap::Reserve(size_t count)
+	{
+		size_t bucketCount = 64;
+		while (bucketCount < (count * 2)) { bucketCount <<= 1; }
 
-void ImDemo::OnAttach()
-{
-	SetAttached(true);
-}
+		if (bucketCount > Buckets.size())
+		{
+			Rehash(bucketCount);
+		}
+	}
 
-void ImDemo::OnDetatch()
-{
-	if (IsAttached())
+	void IndexMap::Clear()
 	{
-		SetAttached(false);
+		Buckets.clear();
+		Mask = 0;
+		Count = 0;
 	}
-}
 
-void ImDemo::OnRender()
-{
-	if (ShouldRender())
+	size_t IndexMap::Hash(int32_t key)
 	{
-		ImGui::ShowDemoWindow(ShouldBegin());
+		// Object indices are mostly sequential, so mix them before masking.
+		uint32_t hash = static_cast<uint32_t>(key);
+		hash ^= (hash >> 16);
+		hash *= 0x85EBCA6Bu;
+		hash ^= (hash >> 13);
+		hash *= 0xC2B2AE35u;
+		hash ^= (hash >> 16);
+		return static_cast<size_t>(hash);
 	}
-}
 
-ImFunctionScanner::ImFunctionScanner(const std::string& title, const std::string& name, std::function<void(std::string, bool)> toggleCallback, bool bShowCursor) : ImInterface(title, name, toggleCallback, bShowCursor) {}
-
-ImFunctionScanner::~ImFunctionScanner()
-{
-	OnDetatch();
-}
+	void IndexMap::Rehash(size_t bucketCount)
+	{
+		std::vector<Bucket> oldBuckets = std::move(Buckets);
+		Buckets.assign(bucketCount, Bucket{ 0, InvalidSlot });
+		Mask = (bucketCount - 1);
+		Count = 0;
 
-void ImFunctionScanner::OnAttach()
-{
-	TableFlags = (ImGuiTableFlags_SizingFixedFit | ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_NoBordersInBody | ImGuiTableFlags_Resizable | ImGuiTableFlags_Reorderable | ImGuiTableFlags_Hideable | ImGuiTableFlags_ScrollY);
-	ScanFunctions = false;
-	SetAttached(true);
-}
+		for (const Bucket& bucket : oldBuckets)
+		{
+			if (bucket.Slot != InvalidSlot)
+			{
+				bool inserted = false;
+				FindOrInsert(bucket.Key, bucket.Slot, inserted);
+			}
+		}
+	}
 
-void ImFunctionScanner::OnDetatch()
-{
-	if (IsAttached())
+	TextMatcher::TextMatcher() : CharClasses{}, ClassCount(1), FilterCount(0), ImplicitMask(0)
 	{
-		SetAttached(false);
+		Compile({});
 	}
-}
 
-void ImFunctionScanner::OnRender()
-{
-	if (ShouldRender())
+	TextMatcher::~TextMatcher() {}
+
+	void TextMatcher::Compile(const std::vector<const ImGuiTextFilter*>& filters)
 	{
-		std::string newTitle = GetTitle();
+		auto foldCase = [](char c) { return static_cast<uint8_t>(((c >= 'a') && (c <= 'z')) ? (c - 'a' + 'A') : c); };
 
-		if (!FunctionHistory.empty())
-		{
-			newTitle += (" - " + (HideDuplicates ? std::to_string(FunctionMap.size()) : std::to_string(FunctionHistory.size())) + " Functions###FunctionScanner");
-		}
-		else
-		{
-			newTitle += "###FunctionScanner";
-		}
+		FilterCount = std::min(filters.size(), MaxFilters);
+		Excludes.assign(FilterCount, {});
+		ImplicitMask = 0;
+		CharClasses.fill(0);
+		ClassCount = 1;
 
-		ImGui::SetNextWindowSize(ImVec2(500.0f, 625.0f), ImGuiCond_Once);
+		// Terms with the leading '-' already stripped, an exclude term with nothing after it can never match (same as "ImStristr").
+		std::vector<std::tuple<size_t, uint16_t, std::string_view>> terms;
 
-		if (ImGui::Begin(newTitle.c_str(), ShouldBegin(), ImGuiWindowFlags_NoNav))
+		for (size_t filter = 0; filter < FilterCount; filter++)
 		{
-			SetIsFocused(ImGui::IsWindowFocused());
+			const ImGuiTextFilter& textFilter = *filters[filter];
+			uint16_t termIndex = 0;
 
-			if (ImGui::BeginTable("###Scanner_Filter", 2))
+			if (textFilter.CountGrep == 0) // Includes filters with no terms at all.
 			{
-				ImGui::TableSetupColumn("Text", ImGuiTableColumnFlags_WidthFixed, 50.0f);
-				ImGui::TableSetupColumn("Value", ImGuiTableColumnFlags_WidthStretch);
+				ImplicitMask |= (1u << filter);
+			}
 
-				// Whitelist
+			for (const ImGuiTextFilter::ImGuiTextRange& range : textFilter.Filters)
+			{
+				if (range.empty())
 				{
-					ImGui::TableNextRow();
-					ImGui::TableSetColumnIndex(0);
-					ImGui::TextUnformatted("Whitelist");
-					ImGui::TableSetColumnIndex(1);
-					Whitelist.Draw(" Filter: (\"incl\") (\"error\")###Scanner_Whitelist");
+					continue;
 				}
 
-				// Blacklist
+				bool exclude = (range.b[0] == '-');
+				std::string_view term((range.b + (exclude ? 1 : 0)), static_cast<size_t>(range.e - range.b - (exclude ? 1 : 0)));
+				Excludes[filter].push_back(exclude ? 1 : 0);
+
+				if (!term.empty())
 				{
-					ImGui::TableNextRow();
-					ImGui::TableSetColumnIndex(0);
-					ImGui::TextUnformatted("Blacklist");
-					ImGui::TableSetColumnIndex(1);
-					Blacklist.Draw(" Filter: (\"excl\") (\"error\")###Scanner_Blacklist");
+					terms.emplace_back(filter, termIndex, term);
+
+					for (char c : term)
+					{
+						uint8_t folded = foldCase(c);
+
+						if (CharClasses[folded] == 0)
+						{
+							CharClasses[folded] = static_cast<uint8_t>(ClassCount++); // At most 230 distinct folded bytes, so this can't overflow.
+						}
+					}
 				}
 
-				ImGui::EndTable();
+				termIndex++;
 			}
+		}
 
-			ImGui::Spacing();
+		for (size_t c = 'a'; c <= 'z'; c++)
+		{
+			CharClasses[c] = CharClasses[c - 'a' + 'A'];
+		}
 
-			if (IsScanning()) { if (ImGui::Button("Stop Monitoring")) { ScanFunctions = false; } }
-			else { if (ImGui::Button("Start Monitoring")) { ScanFunctions = true; } }
+		// Trie first, zero means "no edge" here since nothing can transition back into the root.
+		Transitions.assign(ClassCount, 0);
+		FirstTerms.assign(FilterCount, NoTerm);
+		Outputs.assign(1, 0);
 
-			ImGui::SameLine(); if (ImGui::Button("Clear Table")) { FunctionHistory.clear(); }
-			ImGui::SameLine(); if (ImGui::Button("Save to File")) { SaveToFile(); }
-			ImGui::SameLine(); ImGui::Checkbox("Hide duplicates###Scanner_Hide_Dupes", &HideDuplicates);
-			ImGui::Spacing();
+		for (const auto& [filter, termIndex, term] : terms)
+		{
+			uint32_t state = 0;
 
-			if (HideDuplicates)
+			for (char c : term)
 			{
-				if (ImGui::BeginTable("###FunctionScanner_Duplicate_Table", 4, TableFlags))
+				uint32_t& next = Transitions[(state * ClassCount) + CharClasses[foldCase(c)]];
+
+				if (next == 0)
 				{
-					bool copy_to_clipboard = false;
+					next = static_cast<uint32_t>(Outputs.size());
+					Transitions.resize(Transitions.size() + ClassCount, 0);
+					FirstTerms.resize(FirstTerms.size() + FilterCount, NoTerm);
+					Outputs.push_back(0);
+				}
 
-					if (ImGui::BeginPopupContextWindow())
-					{
-						copy_to_clipboard = ImGui::Selectable("Copy to Clipboard");
-						ImGui::EndPopup();
-					}
+				state = Transitions[(state * ClassCount) + CharClasses[foldCase(c)]];
+			}
 
-					ImGui::TableSetupColumn("Calls", ImGuiTableColumnFlags_WidthFixed, 20.0f);
-					ImGui::TableSetupColumn("Package Object", ImGuiTableColumnFlags_WidthFixed, 100.0f);
-					ImGui::TableSetupColumn("Calling Class", ImGuiTableColumnFlags_WidthStretch);
-					ImGui::TableSetupColumn("Function Name", ImGuiTableColumnFlags_WidthStretch);
-					ImGui::TableHeadersRow();
+			uint16_t& firstTerm = FirstTerms[(state * FilterCount) + filter];
+			firstTerm = std::min(firstTerm, termIndex);
+			Outputs[state] = 1;
+		}
 
-					for (const auto& dataIt : FunctionMap)
-					{
-						const ImClasses::FunctionData& data = dataIt.second;
+		// Breadth first so every failure link points at a state that's already complete, then missing edges are copied from it.
+		std::vector<uint32_t> failures(Outputs.size(), 0);
+		std::deque<uint32_t> queue;
 
-						if (PassesFilter(data.FullName))
-						{
-							ImGui::TableNextRow();
-							ImGui::TableSetColumnIndex(0);
-							ImGui::Text("%d", data.Calls);
-							ImGui::TableSetColumnIndex(1);
-							ImGui::TextUnformatted(data.Package.c_str());
-							ImGui::TableSetColumnIndex(2);
-							ImGui::TextUnformatted(data.Caller.c_str());
+		for (size_t c = 0; c < ClassCount; c++)
+		{
+			if (Transitions[c] != 0)
+			{
+				queue.push_back(Transitions[c]);
+			}
+		}
+
+		while (!queue.empty())
+		{
+			uint32_t state = queue.front();
+			queue.pop_front();
+			uint32_t failure = failures[state];
+
+			for (size_t filter = 0; filter < FilterCount; filter++)
+			{
+				uint16_t& firstTerm = FirstTerms[(state * FilterCount) + filter];
+				firstTerm = std::min(firstTerm, FirstTerms[(failure * FilterCount) + filter]);
+			}
+
+			Outputs[state] |= Outputs[failure];
+
+			for (size_t c = 0; c < ClassCount; c++)
+			{
+				uint32_t& next = Transitions[(state * ClassCount) + c];
+
+				if (next != 0)
+				{
+					failures[next] = Transitions[(failure * ClassCount) + c];
+					queue.push_back(next);
+				}
+				else
+				{
+					next = Transitions[(failure * ClassCount) + c];
+				}
+			}
+		}
+	}
+
+	uint32_t TextMatcher::Match(const char* text, size_t length) const
+	{
+		std::array<uint16_t, MaxFilters> firstTerms;
+		std::fill_n(firstTerms.begin(), FilterCount, NoTerm);
+		bool matched = false;
+		uint32_t state = 0;
+
+		for (size_t i = 0; i < length; i++)
+		{
+			state = Transitions[(state * ClassCount) + CharClasses[static_cast<uint8_t>(text[i])]];
+
+			if (Outputs[state])
+			{
+				const uint16_t* stateTerms = &FirstTerms[state * FilterCount];
+				matched = true;
+
+				for (size_t filter = 0; filter < FilterCount; filter++)
+				{
+					firstTerms[filter] = std::min(firstTerms[filter], stateTerms[filter]);
+				}
+			}
+		}
+
+		uint32_t passed = ImplicitMask;
+
+		if (matched)
+		{
+			for (size_t filter = 0; filter < FilterCount; filter++)
+			{
+				if (firstTerms[filter] != NoTerm)
+				{
+					uint32_t bit = (1u << filter);
+					passed = (Excludes[filter][firstTerms[filter]] ? (passed & ~bit) : (passed | bit));
+				}
+			}
+		}
+
+		return passed;
+	}
+
+	size_t TextMatcher::GetStateCount() const
+	{
+		return Outputs.size();
+	}
+
+	size_t TextMatcher::GetBytes() const
+	{
+		return ((Transitions.capacity() * sizeof(uint32_t)) + (FirstTerms.capacity() * sizeof(uint16_t)) + Outputs.capacity() + sizeof(CharClasses));
+	}
+
+	FilterBits::FilterBits() : Capacity(0) {}
+
+	FilterBits::~FilterBits() {}
+
+	void FilterBits::Reserve(size_t capacity)
+	{
+		size_t wordCount = ((capacity + 31) / 32);
+		Words = std::make_unique<std::atomic<uint64_t>[]>(wordCount);
+		Capacity = (wordCount * 32);
+		Clear();
+	}
+
+	void FilterBits::Set(int32_t index, FilterStates state)
+	{
+		if ((index >= 0) && (static_cast<size_t>(index) < Capacity))
+		{
+			// Single writer, so a plain read-modify-write is enough, readers only ever see the old or the new word.
+			std::atomic<uint64_t>& word = Words[static_cast<size_t>(index) >> 5];
+			uint32_t shift = static_cast<uint32_t>((index & 31) * 2);
+			uint64_t value = word.load(std::memory_order_relaxed);
+			value = ((value & ~(3ULL << shift)) | (static_cast<uint64_t>(state) << shift));
+			word.store(value, std::memory_order_relaxed);
+		}
+	}
+
+	void FilterBits::Clear()
+	{
+		for (size_t i = 0; i < (Capacity / 32); i++)
+		{
+			Words[i].store(0, std::memory_order_relaxed);
+		}
+	}
+
+	size_t FilterBits::GetBytes() const
+	{
+		return ((Capacity / 32) * sizeof(uint64_t));
+	}
+
+	EventSource::EventSource() {}
+
+	EventSource::~EventSource() {}
+
+	FunctionData::FunctionData() :
+		FullName(NameTable::NullId),
+		Package(NameTable::NullId),
+		Caller(NameTable::NullId),
+		Function(NameTable::NullId),
+		Index(0),
+		Frame(0),
+		Timestamp(0)
+	{
+
+	}
+
+	FunctionData::FunctionData(const FunctionData& functionData) :
+		FullName(functionData.FullName),
+		Package(functionData.Package),
+		Caller(functionData.Caller),
+		Function(functionData.Function),
+		Index(functionData.Index),
+		Frame(functionData.Frame),
+		Timestamp(functionData.Timestamp)
+	{
+
+	}
+
+	FunctionData::FunctionData(class UObject* caller, class UFunction* function) :
+		FullName(NameTable::NullId),
+		Package(NameTable::NullId),
+		Caller(NameTable::NullId),
+		Function(NameTable::NullId),
+		Index(0),
+		Frame(0),
+		Timestamp(0)
+	{
+		// Requires and actual SDK for your game, so that's why this is commented out.
+		// Strings are only built the first time an object index is seen, after that it's just a lookup.
+
+		//if (caller && function)
+		//{
+		//	Index = function->ObjectInternalInteger;
+		//	FullName = FullNames.Resolve(Index, [&]() { return function->GetFullName(); });
+		//	Package = ObjectNames.Resolve(function->GetPackageObj()->ObjectInternalInteger, [&]() { return function->GetPackageObj()->GetName(); });
+		//	Caller = ObjectNames.Resolve(caller->ObjectInternalInteger, [&]() { return caller->GetName(); });
+		//	Function = ObjectNames.Resolve(Index, [&]() { return function->GetName(); });
+		//}
+	}
+
+	FunctionData::FunctionData(const EventSource& source, const SourceEvent& sourceEvent) :
+		FullName(FullNames.Resolve(sourceEvent.Function, [&]() { return source.GetFullName(sourceEvent.Function); })),
+		Package(ObjectNames.Resolve(sourceEvent.Package, [&]() { return source.GetObjectName(sourceEvent.Package); })),
+		Caller(ObjectNames.Resolve(sourceEvent.Caller, [&]() { return source.GetObjectName(sourceEvent.Caller); })),
+		Function(ObjectNames.Resolve(sourceEvent.Function, [&]() { return source.GetObjectName(sourceEvent.Function); })),
+		Index(sourceEvent.Function),
+		Frame(0),
+		Timestamp(0)
+	{
+
+	}
+
+	FunctionData::FunctionData(const FunctionEvent& functionEvent) :
+		FullName(NameTable::NullId),
+		Package(NameTable::NullId),
+		Caller(ObjectNames.Find(functionEvent.CallerIndex, functionEvent.CallerGeneration)),
+		Function(NameTable::NullId),
+		Index(functionEvent.FunctionIndex),
+		Frame(functionEvent.Frame),
+		Timestamp(0)
+	{
+		uint32_t slot = ResolvedSlots.Find(Index);
+
+		if (slot != IndexMap::InvalidSlot)
+		{
+			FullName = ResolvedFunctions[slot].FullName;
+			Package = ResolvedFunctions[slot].Package;
+			Function = ResolvedFunctions[slot].Function;
+		}
+
+		// Requires an actual SDK for your game, so that's why this is commented out.
+		// Only reached the first time a function or caller is seen, the ring is drained every frame so the object is still alive by the time we get here.
+
+		//if (functionEvent.Caller && functionEvent.Function)
+		//{
+		//	class UFunction* function = functionEvent.Function;
+		//
+		//	if (slot == IndexMap::InvalidSlot)
+		//	{
+		//		bool inserted = false;
+		//		FullName = FullNames.Resolve(Index, [&]() { return function->GetFullName(); });
+		//		Package = ObjectNames.Resolve(function->GetPackageObj()->ObjectInternalInteger, [&]() { return function->GetPackageObj()->GetName(); });
+		//		Function = ObjectNames.Resolve(Index, [&]() { return function->GetName(); });
+		//		ResolvedSlots.FindOrInsert(Index, static_cast<uint32_t>(ResolvedFunctions.size()), inserted);
+		//		ResolvedFunctions.push_back(FunctionNames{ FullName, Package, Function });
+		//	}
+		//
+		//	if (Caller == NameTable::NullId)
+		//	{
+		//		Caller = ObjectNames.Intern(functionEvent.CallerIndex, functionEvent.Caller->GetName(), functionEvent.CallerGeneration);
+		//	}
+		//}
+	}
+
+	FunctionData::FunctionData(const std::string& fullName, const std::string& package, const std::string& caller, const std::string& function, int32_t index) :
+		FullName(FullNames.Intern(index, fullName)),
+		Package(ObjectNames.Intern(package)),
+		Caller(ObjectNames.Intern(caller)),
+		Function(ObjectNames.Intern(index, function)),
+		Index(index),
+		Frame(0),
+		Timestamp(0)
+	{
+
+	}
+
+	FunctionData::~FunctionData() {}
+
+	const std::string& FunctionData::GetFullName() const
+	{
+		return FullNames.Get(FullName);
+	}
+
+	const std::string& FunctionData::GetPackage() const
+	{
+		return ObjectNames.Get(Package);
+	}
+
+	const std::string& FunctionData::GetCaller() const
+	{
+		return ObjectNames.Get(Caller);
+	}
+
+	const std::string& FunctionData::GetFunction() const
+	{
+		return ObjectNames.Get(Function);
+	}
+
+	void FunctionData::ClearNames()
+	{
+		FullNames.Clear();
+		ObjectNames.Clear();
+		ResolvedSlots.Clear();
+		ResolvedFunctions.clear();
+	}
+
+	FunctionData& FunctionData::operator=(const FunctionData& functionData)
+	{
+		FullName = functionData.FullName;
+		Package = functionData.Package;
+		Caller = functionData.Caller;
+		Function = functionData.Function;
+		Index = functionData.Index;
+		Frame = functionData.Frame;
+		Timestamp = functionData.Timestamp;
+		return *this;
+	}
+
+	FunctionCount::FunctionCount() : Calls(0) {}
+
+	FunctionCount::FunctionCount(const FunctionData& functionData) : FunctionData(functionData), Calls(0) {}
+
+	FunctionCount::~FunctionCount() {}
+
+	HistoryStore::HistoryStore() : FirstId(0), EndId(0), Evicted(0), MemoryCap(256 * 1024 * 1024) {}
+
+	HistoryStore::~HistoryStore() {}
+
+	uint64_t HistoryStore::Push(const FunctionData& functionData)
+	{
+		size_t blockOffset = static_cast<size_t>(EndId % BlockRecords);
+
+		if (blockOffset == 0)
+		{
+			while (!Blocks.empty() && (((Blocks.size() + 1) * BlockBytes) > MemoryCap))
+			{
+				Evict();
+			}
+
+			Blocks.push_back(SpareBlock ? std::move(SpareBlock) : std::shared_ptr<FunctionData[]>(new FunctionData[BlockRecords]));
+		}
+
+		GetWritableBlock(Blocks.size() - 1)[blockOffset] = functionData;
+		return EndId++;
+	}
+
+	const FunctionData& HistoryStore::operator[](uint64_t id) const
+	{
+		uint64_t offset = (id - FirstId);
+		return Blocks[static_cast<size_t>(offset / BlockRecords)][static_cast<size_t>(offset % BlockRecords)];
+	}
+
+	void HistoryStore::Set(uint64_t id, const FunctionData& functionData)
+	{
+		uint64_t offset = (id - FirstId);
+		GetWritableBlock(static_cast<size_t>(offset / BlockRecords))[static_cast<size_t>(offset % BlockRecords)] = functionData;
+	}
+
+	std::vector<SharedRecords> HistoryStore::Share() const
+	{
+		std::vector<SharedRecords> chunks;
+		chunks.reserve(Blocks.size());
+
+		for (size_t block = 0; block < Blocks.size(); block++)
+		{
+			size_t count = ((block + 1 < Blocks.size()) ? BlockRecords : static_cast<size_t>(EndId - FirstId - (block * BlockRecords)));
+			chunks.push_back(SharedRecords{ Blocks[block], count });
+		}
+
+		return chunks;
+	}
+
+	bool HistoryStore::Contains(uint64_t id) const
+	{
+		return ((id >= FirstId) && (id < EndId));
+	}
+
+	bool HistoryStore::Empty() const
+	{
+		return (EndId == FirstId);
+	}
+
+	size_t HistoryStore::Size() const
+	{
+		return static_cast<size_t>(EndId - FirstId);
+	}
+
+	uint64_t HistoryStore::GetFirstId() const
+	{
+		return FirstId;
+	}
+
+	uint64_t HistoryStore::GetEndId() const
+	{
+		return EndId;
+	}
+
+	uint64_t HistoryStore::GetEvicted() const
+	{
+		return Evicted;
+	}
+
+	size_t HistoryStore::GetBytes() const
+	{
+		return (Blocks.size() * BlockBytes);
+	}
+
+	size_t HistoryStore::GetMemoryCap() const
+	{
+		return MemoryCap;
+	}
+
+	void HistoryStore::SetMemoryCap(size_t bytes)
+	{
+		MemoryCap = bytes;
+
+		// Keep the block being written to, everything older than the cap allows goes now.
+		while (((Blocks.size() * BlockBytes) > MemoryCap) && (Blocks.size() >= 2))
+		{
+			Evict();
+		}
+	}
+
+	void HistoryStore::Truncate(size_t size)
+	{
+		if (size >= Size())
+		{
+			return;
+		}
+
+		Evicted += (Size() - size);
+		EndId = (FirstId + size);
+
+		// "FirstId" is always the start of a block, so only whole blocks past the new end can go.
+		while (Blocks.size() > ((size + BlockRecords - 1) / BlockRecords))
+		{
+			SpareBlock = ((Blocks.back().use_count() == 1) ? std::move(Blocks.back()) : nullptr);
+			Blocks.pop_back();
+		}
+	}
+
+	void HistoryStore::Clear()
+	{
+		Blocks.clear();
+		SpareBlock.reset();
+		FirstId = 0;
+		EndId = 0;
+		Evicted = 0;
+	}
+
+	size_t HistoryStore::GetRecordCapacity(size_t memoryCap)
+	{
+		return (std::max<size_t>((memoryCap / BlockBytes), 1) * BlockRecords);
+	}
+
+	FunctionData* HistoryStore::GetWritableBlock(size_t block)
+	{
+		std::shared_ptr<FunctionData[]>& records = Blocks[block];
+
+		// Only this store can hand out new references, so a count of one can't go back up while the block is written.
+		if (records.use_count() != 1)
+		{
+			std::shared_ptr<FunctionData[]> copy(new FunctionData[BlockRecords]);
+			std::copy(records.get(), (records.get() + BlockRecords), copy.get());
+			records = std::move(copy);
+		}
+
+		return records.get();
+	}
+
+	void HistoryStore::Evict()
+	{
+		// A block that's still being saved can't be reused.
+		SpareBlock = ((Blocks.front().use_count() == 1) ? std::move(Blocks.front()) : nullptr);
+		Blocks.pop_front();
+		FirstId += BlockRecords;
+		Evicted += BlockRecords;
+	}
+
+	FunctionEvent::FunctionEvent() : Caller(nullptr), Function(nullptr), Timestamp(0), Duration(0), Weight(1), FunctionIndex(-1), CallerIndex(-1), CallerGeneration(0), Frame(0) {}
+
+	FunctionEvent::FunctionEvent(class UObject* caller, class UFunction* function, int32_t functionIndex, int32_t callerIndex, uint32_t callerGeneration, uint32_t frame, uint64_t timestamp, uint64_t duration, uint32_t weight) :
+		Caller(caller),
+		Function(function),
+		Timestamp(timestamp),
+		Duration(duration),
+		Weight(weight),
+		FunctionIndex(functionIndex),
+		CallerIndex(callerIndex),
+		CallerGeneration(callerGeneration),
+		Frame(frame)
+	{
+
+	}
+
+	FunctionEvent::~FunctionEvent() {}
+
+	void EventClock::Calibrate()
+	{
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+		// Invariant TSC is assumed, which every CPU the game supports has.
+		std::chrono::steady_clock::time_point clockStart = std::chrono::steady_clock::now();
+		uint64_t tickStart = Now();
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		uint64_t tickEnd = Now();
+		double elapsed = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - clockStart).count());
+
+		if ((tickEnd > tickStart) && (elapsed > 0.0))
+		{
+			NanosecondsPerTick = (elapsed / static_cast<double>(tickEnd - tickStart));
+		}
+#endif
+	}
+
+	TokenBucket::TokenBucket() : Owner(nullptr), DueTicks(0), Skipped(0) {}
+
+	TokenBucket::~TokenBucket() {}
+
+	bool TokenBucket::Claim(class UFunction* function)
+	{
+		class UFunction* owner = Owner.load(std::memory_order_relaxed);
+
+		if (!owner && Owner.compare_exchange_strong(owner, function, std::memory_order_relaxed))
+		{
+			owner = function;
+		}
+
+		return (owner == function);
+	}
+
+	bool TokenBucket::TryConsume(uint64_t nowTicks, double ticksPerToken, double capacity, uint32_t& weight)
+	{
+		uint64_t interval = std::max<uint64_t>(static_cast<uint64_t>(ticksPerToken), 1);
+		uint64_t burst = static_cast<uint64_t>(std::max((capacity - 1.0), 0.0) * ticksPerToken); // How far ahead of "nowTicks" the due tick may be, a full bucket minus the token being taken.
+		uint64_t dueTicks = DueTicks.load(std::memory_order_relaxed);
+
+		do
+		{
+			uint64_t start = std::max(dueTicks, nowTicks); // An idle bucket refills up to "capacity", it never banks more.
+
+			if ((start - nowTicks) > burst)
+			{
+				Skipped.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+		}
+		while (!DueTicks.compare_exchange_weak(dueTicks, (std::max(dueTicks, nowTicks) + interval), std::memory_order_relaxed));
+
+		weight = (Skipped.exchange(0, std::memory_order_relaxed) + 1);
+		return true;
+	}
+
+	FunctionRate::FunctionRate() : LastSecond(0), Buckets{} {}
+
+	FunctionRate::~FunctionRate() {}
+
+	void FunctionRate::Add(uint64_t second, uint32_t calls)
+	{
+		if (second > LastSecond)
+		{
+			// Seconds that passed without any calls have to be zeroed before their buckets get reused, at most one full lap.
+			uint64_t skipped = std::min<uint64_t>((second - LastSecond), BucketCount);
+
+			for (uint64_t i = 1; i <= skipped; i++)
+			{
+				Buckets[(LastSecond + i) % BucketCount] = 0;
+			}
+
+			LastSecond = second;
+		}
+		else if ((LastSecond - second) >= BucketCount)
+		{
+			return; // Older than the window, can happen for events drained late.
+		}
+
+		Buckets[second % BucketCount] += calls;
+	}
+
+	uint32_t FunctionRate::GetCalls(uint64_t second) const
+	{
+		if ((second > LastSecond) || ((LastSecond - second) >= BucketCount))
+		{
+			return 0;
+		}
+
+		return Buckets[second % BucketCount];
+	}
+
+	float FunctionRate::GetRate(uint64_t nowSecond, size_t windowSeconds) const
+	{
+		// Only complete seconds are counted, the current one would read low for most of its duration.
+		windowSeconds = std::min(std::max<size_t>(windowSeconds, 1), HistorySeconds);
+		uint64_t calls = 0;
+
+		for (size_t i = 1; (i <= windowSeconds) && (i <= nowSecond); i++)
+		{
+			calls += GetCalls(nowSecond - i);
+		}
+
+		return (static_cast<float>(calls) / static_cast<float>(windowSeconds));
+	}
+
+	void FunctionRate::GetHistory(uint64_t nowSecond, float* values) const
+	{
+		for (size_t i = 0; i < HistorySeconds; i++)
+		{
+			uint64_t offset = (HistorySeconds - i);
+			values[i] = ((offset <= nowSecond) ? static_cast<float>(GetCalls(nowSecond - offset)) : 0.0f);
+		}
+	}
+
+	FunctionTiming::FunctionTiming() : Samples(0), Total(0), Max(0), Buckets{} {}
+
+	FunctionTiming::~FunctionTiming() {}
+
+	void FunctionTiming::Add(uint64_t nanoseconds, uint32_t weight)
+	{
+		Samples += weight;
+		Total += (nanoseconds * weight);
+		Max = std::max(Max, nanoseconds);
+		Buckets[GetBucket(nanoseconds)] += weight;
+	}
+
+	uint64_t FunctionTiming::GetAverage() const
+	{
+		return ((Samples > 0) ? (Total / Samples) : 0);
+	}
+
+	uint64_t FunctionTiming::GetPercentile(double percentile) const
+	{
+		uint64_t target = static_cast<uint64_t>(std::ceil(static_cast<double>(Samples) * percentile));
+		uint64_t seen = 0;
+
+		for (size_t i = 0; i < BucketCount; i++)
+		{
+			seen += Buckets[i];
+
+			if ((seen >= target) && (seen > 0))
+			{
+				return std::min(GetBucketLimit(i), Max);
+			}
+		}
+
+		return Max;
+	}
+
+	void FunctionTiming::FormatTime(char* buffer, size_t bufferSize, uint64_t nanoseconds)
+	{
+		if (nanoseconds >= 1000000000) { snprintf(buffer, bufferSize, "%.2f s", (nanoseconds / 1000000000.0)); }
+		else if (nanoseconds >= 1000000) { snprintf(buffer, bufferSize, "%.2f ms", (nanoseconds / 1000000.0)); }
+		else if (nanoseconds >= 1000) { snprintf(buffer, bufferSize, "%.2f us", (nanoseconds / 1000.0)); }
+		else { snprintf(buffer, bufferSize, "%llu ns", static_cast<unsigned long long>(nanoseconds)); }
+	}
+
+	size_t FunctionTiming::GetBucket(uint64_t nanoseconds)
+	{
+		if (nanoseconds < 2)
+		{
+			return static_cast<size_t>(nanoseconds);
+		}
+
+		// Two buckets per power of two, split on the bit right below the highest set bit.
+		size_t exponent = 63;
+		while (!(nanoseconds & (1ULL << exponent))) { exponent--; }
+		size_t bucket = ((exponent * 2) + ((nanoseconds >> (exponent - 1)) & 1));
+		return std::min(bucket, (BucketCount - 1));
+	}
+
+	uint64_t FunctionTiming::GetBucketLimit(size_t bucket)
+	{
+		if (bucket < 2)
+		{
+			return static_cast<uint64_t>(bucket);
+		}
+
+		size_t exponent = (bucket / 2);
+		uint64_t base = (1ULL << exponent);
+		return ((bucket & 1) ? ((base << 1) - 1) : (base + (base >> 1) - 1));
+	}
+
+	CallGraph::CallGraph() : EdgeMask(0)
+	{
+		Clear();
+	}
+
+	CallGraph::~CallGraph() {}
+
+	void CallGraph::Add(uint32_t package, uint32_t caller, uint32_t function, uint64_t calls)
+	{
+		Nodes[RootNode].Calls += calls;
+		GetChild(GetChild(GetChild(RootNode, package, calls), caller, calls), function, calls);
+	}
+
+	const CallGraph::Node& CallGraph::GetNode(uint32_t node) const
+	{
+		return Nodes[node];
+	}
+
+	void CallGraph::SortChildren(uint32_t node)
+	{
+		// Counts only grow between frames, so this is nearly sorted already and insertion sort barely has to move anything.
+		std::vector<uint32_t>& children = Nodes[node].Children;
+
+		for (size_t i = 1; i < children.size(); i++)
+		{
+			uint32_t child = children[i];
+			size_t j = i;
+
+			while ((j > 0) && (Nodes[children[j - 1]].Calls < Nodes[child].Calls))
+			{
+				children[j] = children[j - 1];
+				j--;
+			}
+
+			children[j] = child;
+		}
+	}
+
+	size_t CallGraph::Size() const
+	{
+		return (Nodes.size() - 1);
+	}
+
+	const std::vector<CallGraph::Node>& CallGraph::GetNodes() const
+	{
+		return Nodes;
+	}
+
+	void CallGraph::WriteFolded(const std::vector<Node>& nodes, const std::vector<std::string_view>& names, std::string& out)
+	{
+		std::vector<std::pair<uint32_t, size_t>> stack; // Node and the length of "frames" before it was appended.
+		std::string frames;
+
+		for (uint32_t child : nodes[RootNode].Children)
+		{
+			stack.emplace_back(child, 0);
+		}
+
+		while (!stack.empty())
+		{
+			auto [node, prefixLength] = stack.back();
+			stack.pop_back();
+			frames.resize(prefixLength);
+
+			if (prefixLength > 0)
+			{
+				frames += ';';
+			}
+
+			size_t nameStart = frames.size();
+			frames += ((nodes[node].Name < names.size()) ? names[nodes[node].Name] : std::string_view());
+			std::replace(frames.begin() + nameStart, frames.end(), ';', ':'); // Semicolons separate frames.
+
+			if (nodes[node].Children.empty())
+			{
+				out += frames;
+				out += ' ';
+				out += std::to_string(nodes[node].Calls);
+				out += '\n';
+			}
+			else
+			{
+				for (uint32_t child : nodes[node].Children)
+				{
+					stack.emplace_back(child, frames.size());
+				}
+			}
+		}
+	}
+
+	void CallGraph::Clear()
+	{
+		Nodes.clear();
+		Edges.clear();
+		EdgeMask = 0;
+		Nodes.push_back(Node{ NameTable::NullId, 0, 0, {} });
+	}
+
+	uint32_t CallGraph::GetChild(uint32_t parent, uint32_t name, uint64_t calls)
+	{
+		if ((Nodes.size() * 2) >= Edges.size())
+		{
+			Rehash(std::max<size_t>((Edges.size() * 2), 1024));
+		}
+
+		uint64_t key = ((static_cast<uint64_t>(parent) << 32) | name);
+		size_t bucket = (Hash(key) & EdgeMask);
+
+		while ((Edges[bucket].Child != RootNode) && (Edges[bucket].Key != key))
+		{
+			bucket = ((bucket + 1) & EdgeMask);
+		}
+
+		if (Edges[bucket].Child == RootNode)
+		{
+			uint32_t depth = (Nodes[parent].Depth + 1);
+			Edges[bucket] = Edge{ key, static_cast<uint32_t>(Nodes.size()) };
+			Nodes[parent].Children.push_back(Edges[bucket].Child);
+			Nodes.push_back(Node{ name, depth, 0, {} });
+		}
+
+		uint32_t child = Edges[bucket].Child;
+		Nodes[child].Calls += calls;
+		return child;
+	}
+
+	size_t CallGraph::Hash(uint64_t key)
+	{
+		key ^= (key >> 33);
+		key *= 0xFF51AFD7ED558CCDULL;
+		key ^= (key >> 33);
+		key *= 0xC4CEB9FE1A85EC53ULL;
+		key ^= (key >> 33);
+		return static_cast<size_t>(key);
+	}
+
+	void CallGraph::Rehash(size_t bucketCount)
+	{
+		Edges.assign(bucketCount, Edge{ 0, RootNode });
+		EdgeMask = (bucketCount - 1);
+
+		// Every node but the root is reachable from exactly one edge, so the table can be rebuilt from the tree itself.
+		for (uint32_t parent = 0; parent < static_cast<uint32_t>(Nodes.size()); parent++)
+		{
+			for (uint32_t child : Nodes[parent].Children)
+			{
+				size_t bucket = (Hash((static_cast<uint64_t>(parent) << 32) | Nodes[child].Name) & EdgeMask);
+
+				while (Edges[bucket].Child != RootNode)
+				{
+					bucket = ((bucket + 1) & EdgeMask);
+				}
+
+				Edges[bucket] = Edge{ ((static_cast<uint64_t>(parent) << 32) | Nodes[child].Name), child };
+			}
+		}
+	}
+
+	FrameTimeline::FrameTimeline() : FirstFrame(0), DirtyFrom(0) {}
+
+	FrameTimeline::~FrameTimeline() {}
+
+	void FrameTimeline::Add(uint32_t frame, uint32_t calls)
+	{
+		if (Calls.empty())
+		{
+			FirstFrame = frame;
+		}
+
+		// Producers can race the frame counter by a frame, anything older than what we have is counted towards the first frame.
+		size_t offset = ((frame > FirstFrame) ? (frame - FirstFrame) : 0);
+
+		if (offset >= MaxFrames)
+		{
+			size_t dropped = std::min((offset - (MaxFrames / 2)), Calls.size());
+			Calls.erase(Calls.begin(), (Calls.begin() + dropped));
+			FirstFrame += static_cast<uint32_t>(offset - (MaxFrames / 2));
+			offset = (MaxFrames / 2);
+			DirtyFrom = 0; // Happens once every few hours at most, cheaper to rebuild than to shift every level.
+		}
+
+		if (offset >= Calls.size())
+		{
+			DirtyFrom = std::min(DirtyFrom, Calls.size());
+			Calls.resize((offset + 1), 0);
+		}
+
+		Calls[offset] += calls;
+		DirtyFrom = std::min(DirtyFrom, offset);
+	}
+
+	void FrameTimeline::Update()
+	{
+		if (DirtyFrom >= Calls.size())
+		{
+			return;
+		}
+
+		size_t levelCount = 0;
+
+		for (size_t size = Calls.size(); size > 1; size = ((size + 1) / 2))
+		{
+			levelCount++;
+		}
+
+		Levels.resize(levelCount);
+
+		for (size_t level = 1; level <= levelCount; level++)
+		{
+			std::vector<Range>& entries = Levels[level - 1];
+			size_t belowSize = GetLevelSize(level - 1);
+			entries.resize((belowSize + 1) / 2);
+
+			// Only the parents of what changed are recomputed, one entry per level when capture is keeping up.
+			for (size_t entry = (DirtyFrom >> level); entry < entries.size(); entry++)
+			{
+				Range range = Get((level - 1), (entry * 2));
+
+				if (((entry * 2) + 1) < belowSize)
+				{
+					Range right = Get((level - 1), ((entry * 2) + 1));
+					range.Min = std::min(range.Min, right.Min);
+					range.Max = std::max(range.Max, right.Max);
+				}
+
+				entries[entry] = range;
+			}
+		}
+
+		DirtyFrom = Calls.size();
+	}
+
+	size_t FrameTimeline::GetLevelCount() const
+	{
+		return (Levels.size() + 1);
+	}
+
+	size_t FrameTimeline::GetLevelSize(size_t level) const
+	{
+		return ((level == 0) ? Calls.size() : Levels[level - 1].size());
+	}
+
+	FrameTimeline::Range FrameTimeline::Get(size_t level, size_t entry) const
+	{
+		return ((level == 0) ? Range{ Calls[entry], Calls[entry] } : Levels[level - 1][entry]);
+	}
+
+	uint32_t FrameTimeline::GetFirstFrame() const
+	{
+		return FirstFrame;
+	}
+
+	size_t FrameTimeline::GetFrameCount() const
+	{
+		return Calls.size();
+	}
+
+	size_t FrameTimeline::GetBytes() const
+	{
+		size_t bytes = (Calls.capacity() * sizeof(uint32_t));
+
+		for (const std::vector<Range>& entries : Levels)
+		{
+			bytes += (entries.capacity() * sizeof(Range));
+		}
+
+		return bytes;
+	}
+
+	void FrameTimeline::Clear()
+	{
+		FirstFrame = 0;
+		Calls.clear();
+		Levels.clear();
+		DirtyFrom = 0;
+	}
+
+	CaptureWriter::CaptureWriter() : BackPending(false), Closing(false), NamesWritten(false), TailDuration(0), Active(false), RecordsWritten(0), RecordsDropped(0) {}
+
+	CaptureWriter::~CaptureWriter()
+	{
+		if (Thread.joinable())
+		{
+			Thread.join();
+		}
+	}
+
+	bool CaptureWriter::Open(const std::string& filePath)
+	{
+		if (IsActive())
+		{
+			return false;
+		}
+
+		if (Thread.joinable())
+		{
+			Thread.join();
+		}
+
+		File.open(filePath, (std::ios::out | std::ios::binary | std::ios::trunc));
+
+		if (!File.is_open())
+		{
+			return false;
+		}
+
+		CaptureHeader header = { CaptureFormat::Magic, CaptureFormat::Version, sizeof(CaptureRecord), sizeof(CaptureFunction) };
+		File.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+		FrontBlock.clear();
+		FrontBlock.reserve(BlockRecords);
+		BackBlock.clear();
+		BackBlock.reserve(BlockRecords);
+		Chunks.clear();
+		DetachedNames.clear();
+		BackPending = false;
+		Closing = false;
+		NamesWritten = false;
+		RecordsWritten = 0;
+		RecordsDropped = 0;
+		Active = true;
+		Thread = std::thread(&CaptureWriter::WriterThread, this);
+		return true;
+	}
+
+	void CaptureWriter::Append(const FunctionData& functionData)
+	{
+		if (Closing)
+		{
+			return; // The front block belongs to the writer thread until it's finished the file.
+		}
+
+		if (FrontBlock.size() >= BlockRecords)
+		{
+			std::lock_guard<std::mutex> lock(Mutex);
+
+			// The writer thread hands the back block over empty, swapping keeps both blocks' capacity.
+			if (BackPending)
+			{
+				RecordsDropped++;
+				return;
+			}
+
+			std::swap(FrontBlock, BackBlock);
+			BackPending = true;
+			Signal.notify_all();
+		}
+
+		FrontBlock.push_back(ToRecord(functionData));
+	}
+
+	void CaptureWriter::Submit(std::vector<SharedRecords>&& chunks)
+	{
+		std::lock_guard<std::mutex> lock(Mutex);
+		Chunks.insert(Chunks.end(), std::make_move_iterator(chunks.begin()), std::make_move_iterator(chunks.end()));
+		Signal.notify_all();
+	}
+
+	void CaptureWriter::Close(const std::vector<FunctionCount>& functions, uint64_t duration)
+	{
+		if (!IsActive())
+		{
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(Mutex);
+
+			if (Closing)
+			{
+				return;
+			}
+		}
+
+		// Totals are snapshotted here, names only as views (the same way "TableExporter" does), the writer thread appends them after the last block.
+		std::vector<CaptureFunction> tailFunctions;
+		tailFunctions.reserve(functions.size());
+
+		for (const FunctionCount& function : functions)
+		{
+			CaptureRecord record = ToRecord(function);
+			tailFunctions.push_back(CaptureFunction{ record.FullName, record.Package, record.Caller, record.Function, record.Index, 0, function.Calls });
+		}
+
+		std::vector<std::string_view> tailFullNames(FunctionData::FullNames.Size());
+		std::vector<std::string_view> tailObjectNames(FunctionData::ObjectNames.Size());
+		for (size_t i = 0; i < tailFullNames.size(); i++) { tailFullNames[i] = FunctionData::FullNames.Get(static_cast<uint32_t>(i)); }
+		for (size_t i = 0; i < tailObjectNames.size(); i++) { tailObjectNames[i] = FunctionData::ObjectNames.Get(static_cast<uint32_t>(i)); }
+
+		std::lock_guard<std::mutex> lock(Mutex);
+		TailFunctions = std::move(tailFunctions);
+		TailFullNames = std::move(tailFullNames);
+		TailObjectNames = std::move(tailObjectNames);
+		TailDuration = duration;
+		Closing = true; // The front block is written by the writer thread once the back block is done.
+		Signal.notify_all();
+	}
+
+	void CaptureWriter::DetachNames()
+	{
+		std::lock_guard<std::mutex> namesLock(NamesMutex);
+
+		if (NamesWritten)
+		{
+			return;
+		}
+
+		for (std::string_view& name : TailFullNames) { name = DetachedNames.emplace_back(name); }
+		for (std::string_view& name : TailObjectNames) { name = DetachedNames.emplace_back(name); }
+	}
+
+	bool CaptureWriter::IsActive() const
+	{
+		return Active;
+	}
+
+	uint64_t CaptureWriter::GetRecordsWritten() const
+	{
+		return RecordsWritten;
+	}
+
+	uint64_t CaptureWriter::GetRecordsDropped() const
+	{
+		return RecordsDropped;
+	}
+
+	CaptureRecord CaptureWriter::ToRecord(const FunctionData& functionData)
+	{
+		return CaptureRecord{ functionData.FullName, functionData.Package, functionData.Caller, functionData.Function, functionData.Index, functionData.Frame, functionData.Timestamp };
+	}
+
+	void CaptureWriter::WriterThread()
+	{
+		std::vector<CaptureRecord> records;
+		records.reserve(BlockRecords);
+		std::unique_lock<std::mutex> lock(Mutex);
+
+		while (true)
+		{
+			Signal.wait(lock, [this]() { return (BackPending || !Chunks.empty() || Closing); });
+
+			if (BackPending)
+			{
+				lock.unlock();
+				File.write(reinterpret_cast<const char*>(BackBlock.data()), (BackBlock.size() * sizeof(CaptureRecord)));
+				RecordsWritten += BackBlock.size();
+				BackBlock.clear();
+				lock.lock();
+				BackPending = false;
+			}
+			else if (!Chunks.empty())
+			{
+				std::vector<SharedRecords> chunks = std::move(Chunks);
+				Chunks.clear();
+				lock.unlock();
+
+				for (SharedRecords& chunk : chunks)
+				{
+					WriteChunk(chunk, records);
+					chunk.Records.reset(); // Lets the history reuse the block as soon as it's on disk.
+				}
+
+				lock.lock();
+			}
+			else if (Closing)
+			{
+				// "Append" isn't called again after "Close", so the front block is the writer thread's now.
+				lock.unlock();
+				File.write(reinterpret_cast<const char*>(FrontBlock.data()), (FrontBlock.size() * sizeof(CaptureRecord)));
+				RecordsWritten += FrontBlock.size();
+				FrontBlock.clear();
+				WriteTail();
+				File.close();
+				Active = false;
+				return;
+			}
+		}
+	}
+
+	void CaptureWriter::WriteChunk(const SharedRecords& chunk, std::vector<CaptureRecord>& records)
+	{
+		for (size_t first = 0; first < chunk.Count; first += BlockRecords)
+		{
+			size_t last = std::min((first + BlockRecords), chunk.Count);
+			records.clear();
+
+			for (size_t i = first; i < last; i++)
+			{
+				records.push_back(ToRecord(chunk.Records[i]));
+			}
+
+			File.write(reinterpret_cast<const char*>(records.data()), (records.size() * sizeof(CaptureRecord)));
+			RecordsWritten += records.size();
+		}
+	}
+
+	void CaptureWriter::WriteNames(const std::vector<std::string_view>& names)
+	{
+		uint64_t offset = 0;
+		std::vector<uint64_t> offsets;
+		offsets.reserve(names.size() + 1);
+
+		for (std::string_view name : names)
+		{
+			offsets.push_back(offset);
+			offset += name.size();
+		}
+
+		offsets.push_back(offset);
+		File.write(reinterpret_cast<const char*>(offsets.data()), (offsets.size() * sizeof(uint64_t)));
+
+		for (std::string_view name : names)
+		{
+			File.write(name.data(), name.size());
+		}
+
+		Pad();
+	}
+
+	void CaptureWriter::WriteTail()
+	{
+		std::lock_guard<std::mutex> namesLock(NamesMutex); // "DetachNames" waits for this instead of the names going away underneath it.
+		CaptureFooter footer = {};
+		footer.RecordsOffset = sizeof(CaptureHeader);
+		footer.RecordCount = RecordsWritten;
+		footer.FunctionsOffset = static_cast<uint64_t>(File.tellp());
+		footer.FunctionCount = TailFunctions.size();
+		File.write(reinterpret_cast<const char*>(TailFunctions.data()), (TailFunctions.size() * sizeof(CaptureFunction)));
+
+		footer.FullNamesOffset = static_cast<uint64_t>(File.tellp());
+		footer.FullNameCount = TailFullNames.size();
+		WriteNames(TailFullNames);
+
+		footer.ObjectNamesOffset = static_cast<uint64_t>(File.tellp());
+		footer.ObjectNameCount = TailObjectNames.size();
+		WriteNames(TailObjectNames);
+
+		footer.Duration = TailDuration;
+		footer.Magic = CaptureFormat::Magic;
+		footer.Version = CaptureFormat::Version;
+		File.write(reinterpret_cast<const char*>(&footer), sizeof(footer));
+
+		TailFunctions.clear();
+		TailFullNames.clear();
+		TailObjectNames.clear();
+		DetachedNames.clear();
+		NamesWritten = true;
+	}
+
+	void CaptureWriter::Pad()
+	{
+		static const char zeros[8] = { 0 };
+		size_t remainder = (static_cast<size_t>(File.tellp()) % 8);
+
+		if (remainder != 0)
+		{
+			File.write(zeros, (8 - remainder));
+		}
+	}
+
+	TableExporter::TableExporter() : Running(false), Cancelled(false), RowsWritten(0), Format(ExportFormats::Clipboard), HistoryTable(false), NowSecond(0), RateWindows{}, HistoryFirstId(0), Failed(false) {}
+
+	TableExporter::~TableExporter()
+	{
+		Cancel();
+	}
+
+	bool TableExporter::Start(ExportFormats format, const std::string& filePath, std::vector<FunctionData>&& rows, std::vector<ExportStats>&& stats, uint64_t nowSecond, const std::array<uint32_t, 3>& rateWindows)
+	{
+		if (IsRunning())
+		{
+			return false;
+		}
+
+		HistoryTable = false;
+		Rows = std::move(rows);
+		Stats = std::move(stats);
+		NowSecond = nowSecond;
+		RateWindows = rateWindows;
+		return Launch(format, filePath);
+	}
+
+	bool TableExporter::Start(ExportFormats format, const std::string& filePath, std::vector<SharedRecords>&& history, std::vector<uint64_t>&& ids, uint64_t firstId)
+	{
+		if (IsRunning())
+		{
+			return false;
+		}
+
+		HistoryTable = true;
+		History = std::move(history);
+		HistoryIds = std::move(ids);
+		HistoryFirstId = firstId;
+		return Launch(format, filePath);
+	}
+
+	bool TableExporter::Start(const std::string& filePath, std::vector<CallGraph::Node>&& graph)
+	{
+		if (IsRunning())
+		{
+			return false;
+		}
+
+		HistoryTable = false;
+		GraphNodes = std::move(graph);
+		return Launch(ExportFormats::Flamegraph, filePath);
+	}
+
+	bool TableExporter::Launch(ExportFormats format, const std::string& filePath)
+	{
+		if (Thread.joinable())
+		{
+			Thread.join();
+		}
+
+		// Only the views are copied, one per distinct name, which is far less than one per row.
+		FullNames.resize(FunctionData::FullNames.Size());
+		ObjectNames.resize(FunctionData::ObjectNames.Size());
+		for (size_t i = 0; i < FullNames.size(); i++) { FullNames[i] = FunctionData::FullNames.Get(static_cast<uint32_t>(i)); }
+		for (size_t i = 0; i < ObjectNames.size(); i++) { ObjectNames[i] = FunctionData::ObjectNames.Get(static_cast<uint32_t>(i)); }
+
+		Format = format;
+		FilePath = filePath;
+		ClipboardText.clear();
+		Failed = false;
+		Cancelled = false;
+		RowsWritten = 0;
+		Running = true;
+		Thread = std::thread(&TableExporter::ExportThread, this);
+		return true;
+	}
+
+	void TableExporter::Cancel()
+	{
+		Cancelled = true;
+
+		if (Thread.joinable())
+		{
+			Thread.join();
+		}
+
+		Running = false;
+		ClipboardText.clear();
+		Rows = std::vector<FunctionData>();
+		Stats = std::vector<ExportStats>();
+		History = std::vector<SharedRecords>();
+		HistoryIds = std::vector<uint64_t>();
+		GraphNodes = std::vector<CallGraph::Node>();
+	}
+
+	bool TableExporter::IsRunning() const
+	{
+		return Running;
+	}
+
+	size_t TableExporter::GetRowsWritten() const
+	{
+		return RowsWritten;
+	}
+
+	size_t TableExporter::GetRowCount() const
+	{
+		if (Format == ExportFormats::Flamegraph)
+		{
+			return GraphNodes.size();
+		}
+
+		return (HistoryTable ? HistoryIds.size() : Rows.size());
+	}
+
+	ExportFormats TableExporter::GetFormat() const
+	{
+		return Format;
+	}
+
+	const std::string& TableExporter::GetFilePath() const
+	{
+		return FilePath;
+	}
+
+	bool TableExporter::Finish(std::string& clipboardText)
+	{
+		if (IsRunning() || !Thread.joinable())
+		{
+			return false;
+		}
+
+		Thread.join();
+		Rows = std::vector<FunctionData>();
+		Stats = std::vector<ExportStats>();
+		History = std::vector<SharedRecords>();
+		HistoryIds = std::vector<uint64_t>();
+		GraphNodes = std::vector<CallGraph::Node>();
+		FullNames = std::vector<std::string_view>();
+		ObjectNames = std::vector<std::string_view>();
+
+		if ((Format == ExportFormats::Clipboard) && !Failed && !Cancelled && !ClipboardText.empty())
+		{
+			clipboardText = std::move(ClipboardText);
+			ClipboardText.clear();
+			return true;
+		}
+
+		return false;
+	}
+
+	void TableExporter::ExportThread()
+	{
+		std::ofstream file;
+		std::vector<std::string> chunks; // Only kept around for the clipboard, files get each chunk as soon as it fills up.
+		std::string chunk;
+		chunk.reserve(ChunkBytes);
+
+		if (Format != ExportFormats::Clipboard)
+		{
+			file.open(FilePath, (std::ios::out | std::ios::binary | std::ios::trunc));
+			Failed = !file.is_open();
+		}
+
+		auto flushChunk = [&]() {
+			if (Format == ExportFormats::Clipboard)
+			{
+				chunks.push_back(std::move(chunk));
+				chunk = std::string();
+				chunk.reserve(ChunkBytes);
+			}
+			else
+			{
+				file.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+				chunk.clear();
+			}
+		};
+
+		if (!Failed && (Format == ExportFormats::Flamegraph))
+		{
+			CallGraph::WriteFolded(GraphNodes, ObjectNames, chunk); // A single pass over the nodes, nothing to cancel or report part way.
+			flushChunk();
+		}
+		else if (!Failed)
+		{
+			WriteHeader(chunk);
+
+			for (size_t row = 0; row < GetRowCount(); row++)
+			{
+				if (((row & 4095) == 0) && Cancelled.load(std::memory_order_relaxed))
+				{
+					break;
+				}
+
+				WriteRow(chunk, row);
+
+				// Rows are never anywhere near this long, so a chunk never has to grow past its reservation.
+				if (chunk.size() >= (ChunkBytes - 4096))
+				{
+					flushChunk();
+					RowsWritten.store((row + 1), std::memory_order_relaxed);
+				}
+			}
+
+			flushChunk();
+		}
+
+		if (Format == ExportFormats::Clipboard)
+		{
+			size_t totalBytes = 0;
+			for (const std::string& text : chunks) { totalBytes += text.size(); }
+
+			ClipboardText.reserve(totalBytes);
+			for (const std::string& text : chunks) { ClipboardText += text; }
+		}
+		else if (file.is_open())
+		{
+			file.close();
+			Failed = (Failed || file.fail());
+
+			if (Cancelled || Failed)
+			{
+				std::error_code error;
+				std::filesystem::remove(FilePath, error);
+			}
+		}
+
+		if (!Cancelled)
+		{
+			RowsWritten = GetRowCount();
+		}
+
+		Running = false;
+	}
+
+	const FunctionData& TableExporter::GetRow(size_t row) const
+	{
+		if (!HistoryTable)
+		{
+			return Rows[row];
+		}
+
+		uint64_t offset = (HistoryIds[row] - HistoryFirstId); // Same layout as "HistoryStore", blocks start at the first ID.
+		return History[static_cast<size_t>(offset / HistoryStore::BlockRecords)].Records[static_cast<size_t>(offset % HistoryStore::BlockRecords)];
+	}
+
+	void TableExporter::WriteHeader(std::string& chunk) const
+	{
+		if (Format == ExportFormats::Csv)
+		{
+			if (HistoryTable)
+			{
+				chunk += "timestamp_ns,frame,package,caller,function,full_name\n";
+				return;
+			}
+
+			chunk += "calls,package,caller,function,full_name,total_ns,avg_ns,p99_ns,max_ns";
+
+			for (uint32_t window : RateWindows)
+			{
+				chunk += (",rate_" + std::to_string(window) + "s");
+			}
+
+			chunk += '\n';
+		}
+	}
+
+	void TableExporter::WriteRow(std::string& chunk, size_t row) const
+	{
+		const FunctionData& data = GetRow(row);
+		std::string_view fullName = ((data.FullName < FullNames.size()) ? FullNames[data.FullName] : std::string_view());
+		std::string_view package = ((data.Package < ObjectNames.size()) ? ObjectNames[data.Package] : std::string_view());
+		std::string_view caller = ((data.Caller < ObjectNames.size()) ? ObjectNames[data.Caller] : std::string_view());
+		std::string_view function = ((data.Function < ObjectNames.size()) ? ObjectNames[data.Function] : std::string_view());
+
+		if (Format == ExportFormats::Clipboard)
+		{
+			chunk += fullName;
+			chunk += '\n';
+			return;
+		}
+
+		bool json = (Format == ExportFormats::JsonLines);
+
+		if (json) { chunk += "{"; }
+
+		if (HistoryTable)
+		{
+			if (json) { chunk += "\"timestamp_ns\":"; }
+			WriteNumber(chunk, data.Timestamp);
+			chunk += ','; if (json) { chunk += "\"frame\":"; }
+			WriteNumber(chunk, static_cast<uint64_t>(data.Frame));
+		}
+		else
+		{
+			if (json) { chunk += "\"calls\":"; }
+			WriteNumber(chunk, Stats[row].Calls);
+		}
+
+		chunk += ','; if (json) { chunk += "\"package\":"; }
+		WriteText(chunk, package, Format);
+		chunk += ','; if (json) { chunk += "\"caller\":"; }
+		WriteText(chunk, caller, Format);
+		chunk += ','; if (json) { chunk += "\"function\":"; }
+		WriteText(chunk, function, Format);
+		chunk += ','; if (json) { chunk += "\"full_name\":"; }
+		WriteText(chunk, fullName, Format);
+
+		if (!HistoryTable)
+		{
+			const ExportStats& stats = Stats[row];
+			bool timed = (stats.Timing.Samples > 0); // Every timing column is zero otherwise.
+			chunk += ','; if (json) { chunk += "\"total_ns\":"; }
+			WriteNumber(chunk, (timed ? stats.Timing.Total : 0));
+			chunk += ','; if (json) { chunk += "\"avg_ns\":"; }
+			WriteNumber(chunk, (timed ? stats.Timing.GetAverage() : 0));
+			chunk += ','; if (json) { chunk += "\"p99_ns\":"; }
+			WriteNumber(chunk, (timed ? stats.Timing.GetPercentile(0.99) : 0));
+			chunk += ','; if (json) { chunk += "\"max_ns\":"; }
+			WriteNumber(chunk, (timed ? stats.Timing.Max : 0));
+
+			for (size_t i = 0; i < RateWindows.size(); i++)
+			{
+				chunk += ','; if (json) { chunk += ("\"rate_" + std::to_string(RateWindows[i]) + "s\":"); }
+				WriteNumber(chunk, stats.Rate.GetRate(NowSecond, RateWindows[i]));
+			}
+		}
+
+		chunk += (json ? "}\n" : "\n");
+	}
+
+	void TableExporter::WriteText(std::string& chunk, std::string_view text, ExportFormats format)
+	{
+		if (format == ExportFormats::JsonLines)
+		{
+			chunk += '"';
+
+			for (char c : text)
+			{
+				if ((c == '"') || (c == '\\'))
+				{
+					chunk += '\\';
+					chunk += c;
+				}
+				else if (static_cast<uint8_t>(c) < 0x20)
+				{
+					char escaped[8];
+					snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<uint32_t>(static_cast<uint8_t>(c)));
+					chunk += escaped;
+				}
+				else
+				{
+					chunk += c;
+				}
+			}
+
+			chunk += '"';
+		}
+		else if (text.find_first_of(",\"\r\n") != std::string_view::npos)
+		{
+			// RFC 4180, quote the field and double any quotes inside it.
+			chunk += '"';
+
+			for (char c : text)
+			{
+				if (c == '"') { chunk += '"'; }
+				chunk += c;
+			}
+
+			chunk += '"';
+		}
+		else
+		{
+			chunk += text;
+		}
+	}
+
+	void TableExporter::WriteNumber(std::string& chunk, uint64_t value)
+	{
+		char buffer[24];
+		std::to_chars_result result = std::to_chars(buffer, (buffer + sizeof(buffer)), value);
+		chunk.append(buffer, result.ptr);
+	}
+
+	void TableExporter::WriteNumber(std::string& chunk, float value)
+	{
+		// Two decimals is all the rate columns show, and fixed-point is much cheaper than going through printf for every row.
+		uint64_t hundredths = static_cast<uint64_t>(std::llround(std::max((static_cast<double>(value) * 100.0), 0.0)));
+		WriteNumber(chunk, (hundredths / 100));
+		chunk += '.';
+		chunk += static_cast<char>('0' + ((hundredths / 10) % 10));
+		chunk += static_cast<char>('0' + (hundredths % 10));
+	}
+
+	CaptureFile::CaptureFile() : FileHandle(INVALID_HANDLE_VALUE), MappingHandle(nullptr), View(nullptr), ViewSize(0), Footer{} {}
+
+	CaptureFile::~CaptureFile()
+	{
+		Close();
+	}
+
+	bool CaptureFile::Open(const std::string& filePath)
+	{
+		Close();
+
+		FileHandle = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+		if (FileHandle == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+
+		LARGE_INTEGER fileSize;
+
+		if (!GetFileSizeEx(FileHandle, &fileSize) || (static_cast<uint64_t>(fileSize.QuadPart) < (sizeof(CaptureHeader) + (sizeof(uint32_t) * 2))))
+		{
+			Close();
+			return false;
+		}
+
+		MappingHandle = CreateFileMappingA(FileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		View = (MappingHandle ? reinterpret_cast<const uint8_t*>(MapViewOfFile(MappingHandle, FILE_MAP_READ, 0, 0, 0)) : nullptr);
+		ViewSize = static_cast<size_t>(fileSize.QuadPart);
+
+		if (!View)
+		{
+			Close();
+			return false;
+		}
+
+		const CaptureHeader* header = reinterpret_cast<const CaptureHeader*>(View);
+		uint32_t version = 0;
+		memcpy(&version, (View + ViewSize - sizeof(uint32_t)), sizeof(uint32_t)); // Magic and version are the last 8 bytes in every version.
+
+		// Version 1 footers are the same minus "Duration", which sits right before the magic.
+		size_t footerSize = ((version == 1) ? (sizeof(CaptureFooter) - sizeof(uint64_t)) : sizeof(CaptureFooter));
+		bool valid = ((version >= CaptureFormat::OldestVersion) && (version <= CaptureFormat::Version) && (ViewSize >= (sizeof(CaptureHeader) + footerSize)));
+
+		if (valid)
+		{
+			const uint8_t* footerBytes = (View + ViewSize - footerSize);
+			Footer = CaptureFooter{};
+			memcpy(&Footer, footerBytes, (footerSize - (sizeof(uint32_t) * 2)));
+			memcpy(&Footer.Magic, (footerBytes + footerSize - (sizeof(uint32_t) * 2)), (sizeof(uint32_t) * 2));
+
+			valid = ((header->Magic == CaptureFormat::Magic) && (header->Version == version)
+				&& (header->RecordSize == sizeof(CaptureRecord)) && (header->FunctionSize == sizeof(CaptureFunction))
+				&& (Footer.Magic == CaptureFormat::Magic) && (Footer.Version == version)
+				&& ValidateRange(Footer.RecordsOffset, Footer.RecordCount, sizeof(CaptureRecord))
+				&& ValidateRange(Footer.FunctionsOffset, Footer.FunctionCount, sizeof(CaptureFunction))
+				&& ValidateNames(Footer.FullNamesOffset, Footer.FullNameCount)
+				&& ValidateNames(Footer.ObjectNamesOffset, Footer.ObjectNameCount));
+		}
+
+		if (!valid)
+		{
+			Close();
+			return false;
+		}
+
+		return true;
+	}
+
+	void CaptureFile::Close()
+	{
+		if (View) { UnmapViewOfFile(View); }
+		if (MappingHandle) { CloseHandle(MappingHandle); }
+		if (FileHandle != INVALID_HANDLE_VALUE) { CloseHandle(FileHandle); }
+
+		FileHandle = INVALID_HANDLE_VALUE;
+		MappingHandle = nullptr;
+		View = nullptr;
+		ViewSize = 0;
+		Footer = CaptureFooter{};
+	}
+
+	bool CaptureFile::IsOpen() const
+	{
+		return (View != nullptr);
+	}
+
+	size_t CaptureFile::GetRecordCount() const
+	{
+		return (IsOpen() ? static_cast<size_t>(Footer.RecordCount) : 0);
+	}
+
+	const CaptureRecord* CaptureFile::GetRecords() const
+	{
+		return (IsOpen() ? reinterpret_cast<const CaptureRecord*>(View + Footer.RecordsOffset) : nullptr);
+	}
+
+	uint64_t CaptureFile::GetDuration() const
+	{
+		return (IsOpen() ? Footer.Duration : 0);
+	}
+
+	size_t CaptureFile::GetFunctionCount() const
+	{
+		return (IsOpen() ? static_cast<size_t>(Footer.FunctionCount) : 0);
+	}
+
+	const CaptureFunction* CaptureFile::GetFunctions() const
+	{
+		return (IsOpen() ? reinterpret_cast<const CaptureFunction*>(View + Footer.FunctionsOffset) : nullptr);
+	}
+
+	std::string_view CaptureFile::GetFullName(uint32_t id) const
+	{
+		return (IsOpen() ? GetName(Footer.FullNamesOffset, Footer.FullNameCount, id) : std::string_view());
+	}
+
+	std::string_view CaptureFile::GetObjectName(uint32_t id) const
+	{
+		return (IsOpen() ? GetName(Footer.ObjectNamesOffset, Footer.ObjectNameCount, id) : std::string_view());
+	}
+
+	bool CaptureFile::ValidateNames(uint64_t offset, uint64_t count) const
+	{
+		// "count + 1" offsets, so the count has to be checked on its own before adding to it.
+		if ((count >= ViewSize) || !ValidateRange(offset, (count + 1), sizeof(uint64_t)))
+		{
+			return false;
+		}
+
+		uint64_t bytesOffset = (offset + ((count + 1) * sizeof(uint64_t)));
+		const uint64_t* offsets = reinterpret_cast<const uint64_t*>(View + offset);
+		return (offsets[count] <= (ViewSize - bytesOffset));
+	}
+
+	bool CaptureFile::ValidateRange(uint64_t offset, uint64_t count, uint64_t elementSize) const
+	{
+		return (((offset % sizeof(uint64_t)) == 0) && (offset <= ViewSize) && (count <= ((ViewSize - offset) / elementSize)));
+	}
+
+	std::string_view CaptureFile::GetName(uint64_t offset, uint64_t count, uint32_t id) const
+	{
+		if (id >= count)
+		{
+			return std::string_view();
+		}
+
+		const uint64_t* offsets = reinterpret_cast<const uint64_t*>(View + offset);
+		const char* bytes = reinterpret_cast<const char*>(offsets + count + 1);
+
+		// Only the last offset was checked on open, a corrupt entry in the middle just reads as an empty name.
+		if ((offsets[id] > offsets[id + 1]) || (offsets[id + 1] > offsets[count]))
+		{
+			return std::string_view();
+		}
+
+		return std::string_view((bytes + offsets[id]), static_cast<size_t>(offsets[id + 1] - offsets[id]));
+	}
+
+	LineLayout::LineLayout() : Base(0.0), FirstId(0) {}
+
+	LineLayout::~LineLayout() {}
+
+	void LineLayout::Reset(uint64_t firstId)
+	{
+		Bottoms.clear();
+		Base = 0.0;
+		FirstId = firstId;
+	}
+
+	void LineLayout::Append(float height)
+	{
+		Bottoms.push_back((Bottoms.empty() ? Base : Bottoms.back()) + height);
+	}
+
+	void LineLayout::Trim(uint64_t firstId)
+	{
+		while ((FirstId < firstId) && !Bottoms.empty())
+		{
+			Base = Bottoms.front();
+			Bottoms.pop_front();
+			FirstId++;
+		}
+
+		if (Bottoms.empty())
+		{
+			Reset(std::max(FirstId, firstId));
+		}
+	}
+
+	uint64_t LineLayout::GetFirstId() const
+	{
+		return FirstId;
+	}
+
+	uint64_t LineLayout::GetEndId() const
+	{
+		return (FirstId + Bottoms.size());
+	}
+
+	float LineLayout::GetTop(uint64_t id) const
+	{
+		return static_cast<float>(((id > FirstId) ? Bottoms[static_cast<size_t>(id - FirstId - 1)] : Base) - Base);
+	}
+
+	float LineLayout::GetHeight() const
+	{
+		return static_cast<float>(Bottoms.empty() ? 0.0 : (Bottoms.back() - Base));
+	}
+
+	uint64_t LineLayout::FindLine(float offset) const
+	{
+		return (FirstId + static_cast<uint64_t>(std::upper_bound(Bottoms.begin(), Bottoms.end(), (Base + offset)) - Bottoms.begin()));
+	}
+
+	TextLog::TextLog() : FirstBlock(0), EndOffset(0) {}
+
+	TextLog::~TextLog() {}
+
+	uint64_t TextLog::Push(const std::string& text, TextColors textColor, TextStyles textStyle)
+	{
+		size_t length = std::min(text.size(), (BlockBytes - 1));
+
+		// Lines never straddle two blocks, whatever's left at the end of one is skipped.
+		if (((EndOffset % BlockBytes) + length + 1) > BlockBytes)
+		{
+			EndOffset += (BlockBytes - (EndOffset % BlockBytes));
+		}
+
+		if (Blocks.empty())
+		{
+			FirstBlock = (EndOffset / BlockBytes);
+		}
+
+		if ((EndOffset / BlockBytes) >= (FirstBlock + Blocks.size()))
+		{
+			if (!SpareBlocks.empty())
+			{
+				Blocks.push_back(std::move(SpareBlocks.back()));
+				SpareBlocks.pop_back();
+			}
+			else
+			{
+				Blocks.push_back(std::make_unique<char[]>(BlockBytes));
+			}
+		}
+
+		char* bytes = (Blocks[static_cast<size_t>((EndOffset / BlockBytes) - FirstBlock)].get() + (EndOffset % BlockBytes));
+		memcpy(bytes, text.data(), length);
+		bytes[length] = '\0';
+
+		uint64_t id = Lines.Push(LineRecord{ EndOffset, static_cast<uint32_t>(length), static_cast<uint8_t>(textColor), textStyle });
+		EndOffset += (length + 1);
+		ReleaseBlocks();
+		return id;
+	}
+
+	const TextLog::LineRecord& TextLog::operator[](size_t position) const
+	{
+		return Lines[position];
+	}
+
+	const char* TextLog::GetText(const LineRecord& line) const
+	{
+		return (Blocks[static_cast<size_t>((line.Offset / BlockBytes) - FirstBlock)].get() + (line.Offset % BlockBytes));
+	}
+
+	ImVec4 TextLog::GetColor(const LineRecord& line) const
+	{
+		std::map<TextColors, ImVec4>::const_iterator colorIt = ImColorMap.find(static_cast<TextColors>(line.Palette));
+		return ((colorIt != ImColorMap.end()) ? colorIt->second : ImColorMap[TextColors::White]);
+	}
+
+	size_t TextLog::Size() const
+	{
+		return Lines.Size();
+	}
+
+	uint64_t TextLog::GetFirstId() const
+	{
+		return Lines.GetFirstId();
+	}
+
+	uint64_t TextLog::GetEndId() const
+	{
+		return Lines.GetEndId();
+	}
+
+	size_t TextLog::GetBytes() const
+	{
+		return (((Blocks.size() + SpareBlocks.size()) * BlockBytes) + (Lines.GetCapacity() * sizeof(LineRecord)));
+	}
+
+	void TextLog::SetCapacity(size_t lineCount)
+	{
+		Lines.SetCapacity(lineCount);
+		ReleaseBlocks();
+	}
+
+	void TextLog::Clear()
+	{
+		Lines.Clear();
+		ReleaseBlocks();
+	}
+
+	void TextLog::ReleaseBlocks()
+	{
+		uint64_t keepFrom = (Lines.Empty() ? (FirstBlock + Blocks.size()) : (Lines[0].Offset / BlockBytes));
+
+		while (!Blocks.empty() && (FirstBlock < keepFrom))
+		{
+			if (SpareBlocks.size() < MaxSpareBlocks)
+			{
+				SpareBlocks.push_back(std::move(Blocks.front()));
+			}
+
+			Blocks.pop_front();
+			FirstBlock++;
+		}
+	}
+
+	CompletionIndex::CompletionIndex() : Dirty(false), MatchedLevels(0) {}
+
+	CompletionIndex::~CompletionIndex() {}
+
+	void CompletionIndex::Add(const std::string& word)
+	{
+		Words.push_back(word);
+		Dirty = true;
+		LastPattern.clear();
+		MatchedLevels = 0;
+	}
+
+	bool CompletionIndex::Remove(const std::string& word)
+	{
+		std::vector<std::string>::iterator wordIt = std::find(Words.begin(), Words.end(), word);
+
+		if (wordIt != Words.end())
+		{
+			// Removing keeps the rest in order, so the keys can be cut out in place instead of sorting again.
+			if (!Dirty)
+			{
+				size_t index = static_cast<size_t>(wordIt - Words.begin());
+				uint32_t keyBytes = (KeyOffsets[index + 1] - KeyOffsets[index]);
+				KeyPool.erase(KeyOffsets[index], keyBytes);
+				WordStarts.erase((WordStarts.begin() + KeyOffsets[index]), (WordStarts.begin() + KeyOffsets[index] + keyBytes));
+				KeyOffsets.erase(KeyOffsets.begin() + index);
+
+				for (size_t i = index; i < KeyOffsets.size(); i++)
+				{
+					KeyOffsets[i] -= keyBytes;
+				}
+
+				// Erasing shifts everything down, refilling the end keeps the padding the SIMD passes read.
+				KeyLengths.erase(KeyLengths.begin() + index);
+				KeyLengths.push_back(0);
+
+				for (std::vector<uint8_t>& positions : Occurrences)
+				{
+					positions.erase(positions.begin() + index);
+					positions.push_back(NoPosition);
+				}
+			}
+
+			Words.erase(wordIt);
+			LastPattern.clear();
+			MatchedLevels = 0;
+			return true;
+		}
+
+		return false;
+	}
+
+	void CompletionIndex::Clear()
+	{
+		Words.clear();
+		KeyPool.clear();
+		WordStarts.clear();
+		KeyOffsets.clear();
+		KeyLengths.clear();
+
+		for (std::vector<uint8_t>& positions : Occurrences)
+		{
+			positions.clear();
+		}
+
+		Dirty = false;
+		LastPattern.clear();
+		LastMatches.clear();
+		MatchedLevels = 0;
+	}
+
+	size_t CompletionIndex::Size() const
+	{
+		return Words.size();
+	}
+
+	size_t CompletionIndex::GetBytes() const
+	{
+		size_t bytes = (KeyPool.capacity() + WordStarts.capacity() + (KeyOffsets.capacity() * sizeof(uint32_t)) + KeyLengths.capacity());
+
+		for (const std::string& word : Words)
+		{
+			bytes += (sizeof(std::string) + word.capacity());
+		}
+
+		for (const std::vector<uint8_t>& positions : Occurrences)
+		{
+			bytes += positions.capacity();
+		}
+
+		for (const MatchLevel& level : LastMatches)
+		{
+			bytes += (level.Positions.capacity() + (level.Scores.capacity() * sizeof(uint16_t)) + (level.Blocks.capacity() * sizeof(uint32_t)) + (level.Deferred.capacity() * sizeof(DeferredWord)));
+		}
+
+		return bytes;
+	}
+
+	size_t CompletionIndex::FindPrefix(const char* prefix, size_t length, size_t maxResults, std::vector<const std::string*>& results)
+	{
+		Sort();
+		results.clear();
+
+		std::string loweredPrefix(prefix, length);
+		std::transform(loweredPrefix.begin(), loweredPrefix.end(), loweredPrefix.begin(), [](char c) { return static_cast<char>(std::tolower(static_cast<uint8_t>(c))); });
+
+		// Keys are sorted, so the ones starting with the prefix are a single run. Both ends are binary searched over word indices.
+		auto comparePrefix = [&](uint32_t index) -> int32_t {
+			return std::string_view(GetKey(index), std::min<size_t>(GetKeyLength(index), length)).compare(loweredPrefix);
+		};
+
+		auto partitionPoint = [](uint32_t low, uint32_t high, const std::function<bool(uint32_t)>& predicate) {
+			while (low < high)
+			{
+				uint32_t middle = (low + ((high - low) / 2));
+				if (predicate(middle)) { low = (middle + 1); }
+				else { high = middle; }
+			}
+
+			return low;
+		};
+
+		uint32_t first = partitionPoint(0, static_cast<uint32_t>(Words.size()), [&](uint32_t index) { return (comparePrefix(index) < 0); });
+		uint32_t last = partitionPoint(first, static_cast<uint32_t>(Words.size()), [&](uint32_t index) { return (comparePrefix(index) == 0); });
+
+		for (uint32_t i = first; (i < last) && (results.size() < maxResults); i++)
+		{
+			results.push_back(&Words[i]);
+		}
+
+		return (last - first);
+	}
+
+	size_t CompletionIndex::FindFuzzy(const char* pattern, size_t length, size_t maxResults, std::vector<const std::string*>& results)
+	{
+		if (length == 0)
+		{
+			return FindPrefix(pattern, length, maxResults, results);
+		}
+
+		Sort();
+		results.clear();
+
+		std::string loweredPattern(pattern, length);
+		std::transform(loweredPattern.begin(), loweredPattern.end(), loweredPattern.begin(), [](char c) { return static_cast<char>(std::tolower(static_cast<uint8_t>(c))); });
+
+		// Greedy matching never looks back, so whatever the pattern shares with the last one is already done and only the characters after it are matched.
+		size_t kept = 0;
+
+		while ((kept < MatchedLevels) && (kept < length) && (LastPattern[kept] == loweredPattern[kept]))
+		{
+			kept++;
+		}
+
+		// Levels past the shared part are overwritten rather than freed, so their memory is reused from one keystroke to the next.
+		// The last level is always matched again, ranking happens as it's matched so a pattern that got shorter doesn't need a pass of its own.
+		MatchedLevels = std::min({ kept, MatchedLevels, (length - 1) });
+
+		if (LastMatches.size() < length)
+		{
+			LastMatches.resize(length);
+		}
+
+		TopMatches top;
+		top.Best.reserve(maxResults);
+		top.MaxResults = maxResults;
+		top.PatternLength = length;
+		top.WorstScore = 0;
+		top.LengthLimit = UINT8_MAX;
+
+		for (size_t i = MatchedLevels; i < length; i++)
+		{
+			Match(loweredPattern[i], ((i == 0) ? nullptr : &LastMatches[i - 1]), LastMatches[i], (((i == (length - 1)) && (maxResults > 0)) ? &top : nullptr));
+		}
+
+		MatchedLevels = length;
+		LastPattern = loweredPattern;
+		std::sort_heap(top.Best.begin(), top.Best.end(), IsBetter);
+
+		for (const std::pair<int32_t, uint32_t>& entry : top.Best)
+		{
+			results.push_back(&Words[entry.second]);
+		}
+
+		return LastMatches[length - 1].Count;
+	}
+
+	void CompletionIndex::Sort()
+	{
+		if (!Dirty)
+		{
+			return;
+		}
+
+		// Sorting the lowercase keys with the original position as a tie break keeps words that only differ in case in the order they were added.
+		std::vector<std::pair<std::string, uint32_t>> keys;
+		keys.reserve(Words.size());
+
+		for (size_t i = 0; i < Words.size(); i++)
+		{
+			std::string key = Words[i];
+			std::transform(key.begin(), key.end(), key.begin(), [](char c) { return static_cast<char>(std::tolower(static_cast<uint8_t>(c))); });
+			keys.emplace_back(std::move(key), static_cast<uint32_t>(i));
+		}
+
+		std::sort(keys.begin(), keys.end());
+
+		std::vector<std::string> sortedWords;
+		sortedWords.reserve(Words.size());
+		KeyPool.clear();
+		WordStarts.clear();
+		KeyOffsets.clear();
+		KeyOffsets.reserve(keys.size() + 1);
+
+		uint32_t paddedSize = static_cast<uint32_t>(((keys.size() + LaneCount - 1) / LaneCount) * LaneCount);
+		KeyLengths.assign(paddedSize, 0);
+
+		for (std::vector<uint8_t>& positions : Occurrences)
+		{
+			positions.assign(paddedSize, NoPosition);
+		}
+
+		for (size_t i = 0; i < keys.size(); i++)
+		{
+			const std::string& key = keys[i].first;
+			const std::string& word = Words[keys[i].second];
+			KeyOffsets.push_back(static_cast<uint32_t>(KeyPool.size()));
+			KeyLengths[i] = static_cast<uint8_t>(std::min<size_t>(key.size(), UINT8_MAX));
+			KeyPool.append(key.c_str(), (key.size() + 1));
+
+			for (size_t position = 0; position <= key.size(); position++)
+			{
+				WordStarts.push_back(((position < key.size()) && IsWordStart(word, position)) ? 1 : 0);
+				size_t slot = ((position < key.size()) ? GetSlot(key[position]) : SlotCount);
+
+				if (slot < SlotCount)
+				{
+					uint8_t entry = ((position < FarPosition) ? static_cast<uint8_t>(position | (WordStarts.back() ? WordStartFlag : 0)) : FarPosition);
+
+					for (size_t occurrence = 0; occurrence < LastOccurrence; occurrence++)
+					{
+						if (Occurrences[(occurrence * SlotCount) + slot][i] == NoPosition)
+						{
+							Occurrences[(occurrence * SlotCount) + slot][i] = entry;
+							break;
+						}
+					}
+
+					Occurrences[(LastOccurrence * SlotCount) + slot][i] = entry;
+				}
+			}
+
+			sortedWords.push_back(std::move(Words[keys[i].second]));
+		}
+
+		KeyOffsets.push_back(static_cast<uint32_t>(KeyPool.size()));
+		KeyPool.append(KeyPadding, '\0');
+		Words.swap(sortedWords);
+
+		// The first level isn't stored and the next few usually still cover most words, touching their memory here keeps the page faults out of the first keystrokes.
+		LastMatches.resize(std::max<size_t>(LastMatches.size(), 4));
+
+		for (size_t i = 1; i < 4; i++)
+		{
+			LastMatches[i].Positions.resize(std::max<size_t>(LastMatches[i].Positions.size(), paddedSize));
+			LastMatches[i].Scores.resize(std::max<size_t>(LastMatches[i].Scores.size(), paddedSize));
+			LastMatches[i].Blocks.reserve(paddedSize / LaneCount);
+		}
+
+		Dirty = false;
+		LastPattern.clear();
+		MatchedLevels = 0;
+	}
+
+	void CompletionIndex::Match(char c, const MatchLevel* previous, MatchLevel& level, TopMatches* top) const
+	{
+		uint32_t count = static_cast<uint32_t>(Words.size());
+		size_t slot = GetSlot(c);
+		const uint8_t* positions = ((slot < SlotCount) ? GetOccurrences(slot, 0) : nullptr);
+		const uint8_t* previousColumn = (previous ? previous->Column : nullptr);
+		char previousCharacter = (previous ? previous->Character : '\0');
+		const uint8_t* previousPositions = ((previous && !previousColumn) ? previous->Positions.data() : nullptr);
+		const uint16_t* previousScores = ((previous && !previousColumn) ? previous->Scores.data() : nullptr);
+		const uint32_t* previousBlocks = ((previous && !previousColumn) ? previous->Blocks.data() : nullptr);
+		size_t blockCount = ((previous && !previousColumn) ? previous->Blocks.size() : (GetPaddedSize() / LaneCount)); // Matching only ever narrows, so past the first level just the blocks the previous one matched in are visited.
+		size_t matchCount = 0;
+		level.Column = nullptr;
+		level.Character = c;
+
+		// Where a word matched the previous level and what it scored so far, for the words the columns don't settle.
+		auto getPrevious = [this, previousColumn, previousCharacter, previousPositions, previousScores](uint32_t index, uint32_t from, int32_t& previousPosition, int32_t& previousScore) {
+			if (previousColumn)
+			{
+				uint8_t entry = previousColumn[index];
+				previousPosition = ((entry == NoPosition) ? -1 : (((entry & ~WordStartFlag) != FarPosition) ? (entry & ~WordStartFlag) : FindChar(GetKey(index), 0, std::min(GetKeyLength(index), static_cast<uint32_t>(MaxPosition + 1)), previousCharacter)));
+				previousScore = ((previousPosition >= 0) ? GetStepScore(index, -1, previousPosition) : 0);
+				return (previousPosition >= 0);
+			}
+
+			previousPosition = (previousPositions ? (previousPositions[from] - 1) : -1);
+			previousScore = (previousScores ? previousScores[from] : 0);
+			return (!previousPositions || (previousPositions[from] != NoMatch));
+		};
+
+		// The columns rule out words without "c" at all, and when its first "c" comes after the last match that's where greedy matching lands anyway.
+		// Only the words left over touch the key pool. "from" is where the word is in "previous", "position" and "score" are where it matched "c" and its score with it.
+		auto matchWord = [this, c, positions, &getPrevious](uint32_t index, uint32_t from, int32_t& position, int32_t& score) {
+			int32_t previousPosition = -1;
+			int32_t previousScore = 0;
+
+			if (!getPrevious(index, from, previousPosition, previousScore) || (positions && (positions[index] == NoPosition)))
+			{
+				return false;
+			}
+			else if (positions && (positions[index] != FarPosition) && (static_cast<int32_t>(positions[index] & ~WordStartFlag) > previousPosition))
+			{
+				position = (positions[index] & ~WordStartFlag);
+			}
+			else
+			{
+				position = FindChar(GetKey(index), static_cast<uint32_t>(previousPosition + 1), std::min(GetKeyLength(index), static_cast<uint32_t>(MaxPosition + 1)), c);
+			}
+
+			score = (previousScore + ((position >= 0) ? GetStepScore(index, previousPosition, position) : 0));
+			return (position >= 0);
+		};
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)) || defined(__SSE2__)
+		// Sixteen words per step, the same score "GetStepScore" gives for every word whose columns already say where it matches. Lanes the columns settle are counted with a byte sum, the rest one by one.
+		// A step scores "16 - min(gap, 8)", 24 more if it's right after the previous match, 16 more on a word start and 20 instead at the very start. At most 60, so it's worked out in bytes and widened to add.
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i ones = _mm_set1_epi8(-1);
+		const __m128i mask = _mm_set1_epi8(static_cast<char>(~WordStartFlag));
+		const __m128i far = _mm_set1_epi8(FarPosition);
+		const __m128i noPosition = _mm_set1_epi8(static_cast<char>(NoPosition));
+		__m128i knownSums = zero;
+
+		auto getFirstStep = [&](__m128i column, __m128i position) {
+			__m128i step = _mm_sub_epi8(_mm_set1_epi8(16), _mm_min_epu8(position, _mm_set1_epi8(8)));
+			step = _mm_add_epi8(step, _mm_and_si128(_mm_cmpgt_epi8(zero, column), _mm_set1_epi8(16))); // The flag is the sign bit.
+			return _mm_add_epi8(step, _mm_and_si128(_mm_cmpeq_epi8(position, zero), _mm_set1_epi8(4)));
+		};
+
+		// Once "top" is full, a block is only looked at lane by lane if something in it beats the worst kept word, or ties it with a word that's shorter. Kept in locals and only refreshed after an "Offer".
+		// Scores stay well below "INT16_MAX", so signed compares work.
+		bool topFull = false;
+		__m128i worstScore = zero; // "WorstScore" per 16-bit lane.
+		__m128i worstBelow = zero; // "WorstScore - 1" per 16-bit lane.
+		__m128i firstReached = zero; // Highest first level column entry, with "WordStartFlag" flipped, whose step reaches "WorstScore".
+		__m128i firstHigher = zero; // Same for beating it.
+		__m128i firstCanBeat = zero; // All set unless "WorstScore" is already 36, the best a first step can do.
+		__m128i lengthLimit = zero;
+
+		// With the flag flipped word starts come first, so the first step only goes down as the entry goes up and each check is a single unsigned compare.
+		// Word starts step 24 to 32 plus 4 at the very start, anything else 8 to 16 plus the same 4.
+		auto getFirstLimit = [](int32_t score) {
+			return ((score <= 8) ? (UINT8_MAX - 1) : ((score <= 15) ? (WordStartFlag + 16 - score) : ((score <= 20) ? WordStartFlag : ((score <= 24) ? (FarPosition - 1) : ((score <= 31) ? (32 - score) : 0)))));
+		};
+
+		auto updateTop = [&]() {
+			int32_t worst = static_cast<int32_t>(top->WorstScore);
+			topFull = (top->Best.size() == top->MaxResults);
+			worstScore = _mm_set1_epi16(static_cast<short>(worst));
+			worstBelow = _mm_set1_epi16(static_cast<short>(worst - 1));
+			firstReached = _mm_set1_epi8(static_cast<char>(getFirstLimit(worst)));
+			firstHigher = _mm_set1_epi8(static_cast<char>(getFirstLimit(worst + 1)));
+			firstCanBeat = ((worst < 36) ? ones : zero);
+			lengthLimit = _mm_set1_epi8(static_cast<char>(top->LengthLimit));
+		};
+
+		// Packing the two halves keeps each lane's mask. Blocks where nothing even ties are the most common once "top" settles, and never touch "KeyLengths".
+		auto getRankLanes = [&](__m128i scoresLow, __m128i scoresHigh, uint32_t first) {
+			__m128i reached = _mm_packs_epi16(_mm_cmpgt_epi16(scoresLow, worstBelow), _mm_cmpgt_epi16(scoresHigh, worstBelow));
+
+			if (_mm_movemask_epi8(reached) == 0)
+			{
+				return 0u;
+			}
+
+			__m128i lengths = _mm_loadu_si128(reinterpret_cast<const __m128i*>(KeyLengths.data() + first));
+			__m128i higher = _mm_packs_epi16(_mm_cmpgt_epi16(scoresLow, worstScore), _mm_cmpgt_epi16(scoresHigh, worstScore));
+			__m128i shorter = _mm_cmpeq_epi8(_mm_min_epu8(lengths, lengthLimit), lengths);
+			return static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(higher, _mm_and_si128(reached, shorter))));
+		};
+
+		if (positions && !previous)
+		{
+			// Nothing to be past yet, so the first occurrence is always the match and only far ones are searched. Nothing is written, the next level reads the column again.
+			alignas(16) uint16_t blockScores[LaneCount];
+			level.Column = positions;
+			level.Blocks.clear();
+
+			for (uint32_t block = 0; block < static_cast<uint32_t>(blockCount); block++)
+			{
+				uint32_t first = (block * LaneCount);
+				__m128i column = _mm_loadu_si128(reinterpret_cast<const __m128i*>(positions + first));
+				__m128i present = _mm_xor_si128(_mm_cmpeq_epi8(column, noPosition), ones);
+				__m128i position = _mm_and_si128(column, mask);
+				__m128i known = _mm_andnot_si128(_mm_cmpeq_epi8(position, far), present);
+				knownSums = _mm_add_epi64(knownSums, _mm_sad_epu8(_mm_and_si128(known, _mm_set1_epi8(1)), zero));
+				uint32_t matched = static_cast<uint32_t>(_mm_movemask_epi8(known));
+
+				if (top && (matched != 0))
+				{
+					uint32_t lanes = matched;
+
+					if (topFull)
+					{
+						// The same filter as "getRankLanes" without widening the steps first.
+						__m128i flipped = _mm_xor_si128(column, _mm_set1_epi8(static_cast<char>(WordStartFlag)));
+						__m128i lengths = _mm_loadu_si128(reinterpret_cast<const __m128i*>(KeyLengths.data() + first));
+						__m128i higher = _mm_and_si128(_mm_cmpeq_epi8(_mm_min_epu8(flipped, firstHigher), flipped), firstCanBeat);
+						__m128i reached = _mm_cmpeq_epi8(_mm_min_epu8(flipped, firstReached), flipped);
+						__m128i shorter = _mm_cmpeq_epi8(_mm_min_epu8(lengths, lengthLimit), lengths);
+						lanes &= static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(higher, _mm_and_si128(reached, shorter))));
+					}
+
+					if (lanes != 0)
+					{
+						__m128i step = getFirstStep(column, position);
+						_mm_store_si128(reinterpret_cast<__m128i*>(blockScores), _mm_unpacklo_epi8(step, zero));
+						_mm_store_si128(reinterpret_cast<__m128i*>(blockScores + (LaneCount / 2)), _mm_unpackhi_epi8(step, zero));
+
+						for (; lanes != 0; lanes &= (lanes - 1))
+						{
+							uint32_t lane = GetLowestBit(lanes);
+							Offer(blockScores[lane], (first + lane), *top);
+						}
+
+						updateTop();
+					}
+				}
+
+				for (uint32_t remaining = (static_cast<uint32_t>(_mm_movemask_epi8(present)) & ~matched); remaining != 0; remaining &= (remaining - 1))
+				{
+					uint32_t lane = GetLowestBit(remaining);
+					int32_t wordPosition = -1;
+					int32_t wordScore = 0;
+
+					if (matchWord((first + lane), 0, wordPosition, wordScore))
+					{
+						matchCount++;
+
+						if (top)
+						{
+							Offer(wordScore, (first + lane), *top);
+							updateTop();
+						}
+					}
+				}
+			}
+
+			level.Count = (matchCount + static_cast<uint32_t>(_mm_cvtsi128_si32(knownSums) + _mm_cvtsi128_si32(_mm_srli_si128(knownSums, 8))));
+			return;
+		}
+#endif
+
+		// Sized for every block visited up front and trimmed once at the end, so each block is written without a branch and dropped again by the next one if nothing in it matched.
+		level.Blocks.resize(blockCount);
+
+		if (level.Positions.size() < (blockCount * LaneCount))
+		{
+			level.Positions.resize(blockCount * LaneCount);
+			level.Scores.resize(blockCount * LaneCount);
+		}
+
+		// Everything the loops touch is kept in locals that nothing takes the address of, stores through them would otherwise make the compiler reload them after each one.
+		uint8_t* outputPositions = level.Positions.data();
+		uint16_t* outputScores = level.Scores.data();
+		uint32_t* outputBlocks = level.Blocks.data();
+		uint32_t blocksMatched = 0;
+		level.Deferred.clear();
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)) || defined(__SSE2__)
+		if (positions)
+		{
+			// The first occurrence past the previous match, looked for through the columns in order. Positions are stored one up, so "position >= before" is "position > previous position".
+			// If the last occurrence isn't past it either the word is out, anything else is searched.
+			for (uint32_t entry = 0; entry < static_cast<uint32_t>(blockCount); entry++)
+			{
+				uint32_t block = (previousBlocks ? previousBlocks[entry] : entry);
+				uint32_t first = (block * LaneCount);
+				uint32_t from = (entry * LaneCount);
+				uint32_t to = (blocksMatched * LaneCount);
+				__m128i before = zero;
+				__m128i previousLow = zero;
+				__m128i previousHigh = zero;
+				uint32_t searched = 0; // Matched the previous level too far in for its column to say where.
+
+				if (previousColumn)
+				{
+					__m128i previousEntries = _mm_loadu_si128(reinterpret_cast<const __m128i*>(previousColumn + first));
+					__m128i previousPosition = _mm_and_si128(previousEntries, mask);
+					__m128i previousFar = _mm_cmpeq_epi8(previousPosition, far);
+					__m128i previousStep = getFirstStep(previousEntries, previousPosition);
+					before = _mm_andnot_si128(previousFar, _mm_sub_epi8(previousPosition, ones));
+					previousLow = _mm_unpacklo_epi8(previousStep, zero);
+					previousHigh = _mm_unpackhi_epi8(previousStep, zero);
+					searched = static_cast<uint32_t>(_mm_movemask_epi8(_mm_andnot_si128(_mm_cmpeq_epi8(previousEntries, noPosition), previousFar)));
+				}
+				else
+				{
+					before = _mm_loadu_si128(reinterpret_cast<const __m128i*>(previousPositions + from));
+					previousLow = _mm_loadu_si128(reinterpret_cast<const __m128i*>(previousScores + from));
+					previousHigh = _mm_loadu_si128(reinterpret_cast<const __m128i*>(previousScores + from + (LaneCount / 2)));
+				}
+
+				__m128i column = _mm_loadu_si128(reinterpret_cast<const __m128i*>(positions + first));
+				__m128i absent = _mm_cmpeq_epi8(column, noPosition);
+				__m128i present = _mm_andnot_si128(_mm_or_si128(absent, _mm_cmpeq_epi8(before, zero)), ones);
+				__m128i position = _mm_and_si128(column, mask);
+				__m128i pending = _mm_andnot_si128(_mm_cmpeq_epi8(position, far), present); // Still looking through the columns, "NoPosition" masks to "FarPosition" too.
+				__m128i known = _mm_and_si128(pending, _mm_cmpeq_epi8(_mm_max_epu8(position, before), position));
+				uint32_t presentLanes = static_cast<uint32_t>(_mm_movemask_epi8(present));
+				uint32_t matched = static_cast<uint32_t>(_mm_movemask_epi8(known));
+				uint32_t remaining = (searched & ~static_cast<uint32_t>(_mm_movemask_epi8(absent)));
+
+				if ((presentLanes | remaining) == 0)
+				{
+					continue; // Most blocks when the previous level is a column, none of its words can match.
+				}
+
+				if (matched != presentLanes)
+				{
+					pending = _mm_andnot_si128(known, pending);
+
+					for (size_t occurrence = 1; (occurrence < LastOccurrence) && (_mm_movemask_epi8(pending) != 0); occurrence++)
+					{
+						__m128i nextColumn = _mm_loadu_si128(reinterpret_cast<const __m128i*>(GetOccurrences(slot, occurrence) + first));
+						__m128i nextPosition = _mm_and_si128(nextColumn, mask);
+						pending = _mm_andnot_si128(_mm_cmpeq_epi8(nextPosition, far), pending);
+						__m128i found = _mm_and_si128(pending, _mm_cmpeq_epi8(_mm_max_epu8(nextPosition, before), nextPosition));
+						column = _mm_or_si128(_mm_andnot_si128(found, column), _mm_and_si128(found, nextColumn));
+						known = _mm_or_si128(known, found);
+						pending = _mm_andnot_si128(found, pending);
+					}
+
+					__m128i lastPosition = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(GetOccurrences(slot, LastOccurrence) + first)), mask);
+					__m128i ruledOut = _mm_andnot_si128(_mm_or_si128(_mm_cmpeq_epi8(lastPosition, far), _mm_cmpeq_epi8(_mm_max_epu8(lastPosition, before), lastPosition)), present);
+					position = _mm_and_si128(column, mask);
+					matched = static_cast<uint32_t>(_mm_movemask_epi8(known));
+					remaining |= (presentLanes & ~(matched | static_cast<uint32_t>(_mm_movemask_epi8(ruledOut))));
+				}
+
+				__m128i gap = _mm_sub_epi8(position, before);
+				__m128i step = _mm_sub_epi8(_mm_set1_epi8(16), _mm_min_epu8(gap, _mm_set1_epi8(8)));
+				step = _mm_add_epi8(step, _mm_and_si128(_mm_cmpgt_epi8(zero, column), _mm_set1_epi8(16)));
+				step = _mm_add_epi8(step, _mm_and_si128(_mm_cmpeq_epi8(gap, zero), _mm_set1_epi8(24)));
+				__m128i scoresLow = _mm_add_epi16(_mm_unpacklo_epi8(step, zero), previousLow);
+				__m128i scoresHigh = _mm_add_epi16(_mm_unpackhi_epi8(step, zero), previousHigh);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(outputPositions + to), _mm_and_si128(known, _mm_sub_epi8(position, ones)));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(outputScores + to), scoresLow);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(outputScores + to + (LaneCount / 2)), scoresHigh);
+				knownSums = _mm_add_epi64(knownSums, _mm_sad_epu8(_mm_and_si128(known, _mm_set1_epi8(1)), zero));
+
+				uint32_t lanes = ((top && (matched != 0)) ? (topFull ? (getRankLanes(scoresLow, scoresHigh, first) & matched) : matched) : 0);
+
+				if (lanes != 0)
+				{
+					for (; lanes != 0; lanes &= (lanes - 1))
+					{
+						uint32_t lane = GetLowestBit(lanes);
+						Offer(outputScores[to + lane], (first + lane), *top);
+					}
+
+					updateTop();
+				}
+
+				// Written without a branch, the next block overwrites this one if nothing in it matched. Blocks with deferred words are kept even if none of them match, the next level just skips them.
+				outputBlocks[blocksMatched] = block;
+				blocksMatched += ((matched | remaining) != 0);
+
+				for (; remaining != 0; remaining &= (remaining - 1))
+				{
+					uint32_t lane = GetLowestBit(remaining);
+					level.Deferred.push_back(DeferredWord{ (first + lane), (from + lane), (to + lane) });
+				}
+			}
+
+			matchCount += static_cast<uint32_t>(_mm_cvtsi128_si32(knownSums) + _mm_cvtsi128_si32(_mm_srli_si128(knownSums, 8)));
+
+			// Deferred keys are scattered over the pool, fetching a few ahead overlaps their cache misses instead of taking them one at a time.
+			const DeferredWord* deferred = level.Deferred.data();
+			size_t deferredCount = level.Deferred.size();
+
+			for (size_t i = 0; i < deferredCount; i++)
+			{
+				if ((i + PrefetchDistance) < deferredCount)
+				{
+					uint32_t ahead = deferred[i + PrefetchDistance].Index;
+					_mm_prefetch(GetKey(ahead), _MM_HINT_T0);
+					_mm_prefetch(reinterpret_cast<const char*>(WordStarts.data() + KeyOffsets[ahead]), _MM_HINT_T0);
+				}
+
+				int32_t wordPosition = -1;
+				int32_t wordScore = 0;
+
+				if (matchWord(deferred[i].Index, deferred[i].From, wordPosition, wordScore))
+				{
+					outputPositions[deferred[i].To] = static_cast<uint8_t>(wordPosition + 1);
+					outputScores[deferred[i].To] = static_cast<uint16_t>(wordScore);
+					matchCount++;
+
+					if (top)
+					{
+						Offer(wordScore, deferred[i].Index, *top);
+					}
+				}
+			}
+		}
+		else
+#endif
+		{
+			for (uint32_t entry = 0; entry < static_cast<uint32_t>(blockCount); entry++)
+			{
+				uint32_t block = (previousBlocks ? previousBlocks[entry] : entry);
+				uint32_t first = (block * LaneCount);
+				uint32_t from = (entry * LaneCount);
+				uint32_t to = (blocksMatched * LaneCount);
+				uint32_t matched = 0;
+
+				for (uint32_t lane = 0; lane < LaneCount; lane++)
+				{
+					int32_t wordPosition = -1;
+					int32_t wordScore = 0;
+					outputPositions[to + lane] = NoMatch;
+
+					if (((first + lane) < count) && matchWord((first + lane), (from + lane), wordPosition, wordScore))
+					{
+						outputPositions[to + lane] = static_cast<uint8_t>(wordPosition + 1);
+						outputScores[to + lane] = static_cast<uint16_t>(wordScore);
+						matched |= (1u << lane);
+
+						if (top)
+						{
+							Offer(wordScore, (first + lane), *top);
+						}
+					}
+				}
+
+				outputBlocks[blocksMatched] = block;
+				blocksMatched += (matched != 0);
+				matchCount += GetLaneCount(matched);
+			}
+		}
+
+		level.Blocks.resize(blocksMatched);
+		level.Count = matchCount;
+	}
+
+	void CompletionIndex::Offer(int32_t score, uint32_t index, TopMatches& top) const
+	{
+		std::pair<int32_t, uint32_t> entry(((score * 64) + (63 - static_cast<int32_t>(std::min<uint32_t>((GetKeyLength(index) - static_cast<uint32_t>(top.PatternLength)), 63)))), index);
+
+		if (top.Best.size() < top.MaxResults)
+		{
+			top.Best.push_back(entry);
+			std::push_heap(top.Best.begin(), top.Best.end(), IsBetter);
+		}
+		else if (IsBetter(entry, top.Best.front()))
+		{
+			std::pop_heap(top.Best.begin(), top.Best.end(), IsBetter);
+			top.Best.back() = entry;
+			std::push_heap(top.Best.begin(), top.Best.end(), IsBetter);
+		}
+		else
+		{
+			return;
+		}
+
+		if (top.Best.size() == top.MaxResults)
+		{
+			uint8_t worstLength = KeyLengths[top.Best.front().second];
+			top.WorstScore = static_cast<uint16_t>(top.Best.front().first / 64);
+			top.LengthLimit = ((worstLength < UINT8_MAX) ? static_cast<uint8_t>(worstLength - 1) : UINT8_MAX);
+		}
+	}
+
+	uint32_t CompletionIndex::GetPaddedSize() const
+	{
+		return static_cast<uint32_t>(((Words.size() + LaneCount - 1) / LaneCount) * LaneCount);
+	}
+
+	const uint8_t* CompletionIndex::GetOccurrences(size_t slot, size_t occurrence) const
+	{
+		return Occurrences[(occurrence * SlotCount) + slot].data();
+	}
+
+	const char* CompletionIndex::GetKey(uint32_t index) const
+	{
+		return (KeyPool.data() + KeyOffsets[index]);
+	}
+
+	uint32_t CompletionIndex::GetKeyLength(uint32_t index) const
+	{
+		return (KeyOffsets[index + 1] - KeyOffsets[index] - 1);
+	}
+
+	size_t CompletionIndex::GetSlot(char c)
+	{
+		if ((c >= 'a') && (c <= 'z'))
+		{
+			return static_cast<size_t>(c - 'a');
+		}
+		else if ((c >= '0') && (c <= '9'))
+		{
+			return static_cast<size_t>(26 + (c - '0'));
+		}
+
+		switch (c)
+		{
+		case '_': return 36;
+		case ' ': return 37;
+		case '-': return 38;
+		case '.': return 39;
+		case ':': return 40;
+		case '/': return 41;
+		default: return SlotCount;
+		}
+	}
+
+	bool CompletionIndex::IsWordStart(const std::string& word, size_t position)
+	{
+		if (position == 0)
+		{
+			return true;
+		}
+
+		char before = word[position - 1];
+		return ((before == '_') || (before == ' ') || (before == '-') || (before == '.') || (before == ':') || (before == '/') || (std::islower(static_cast<uint8_t>(before)) && std::isupper(static_cast<uint8_t>(word[position]))));
+	}
+
+	bool CompletionIndex::IsBetter(const std::pair<int32_t, uint32_t>& left, const std::pair<int32_t, uint32_t>& right)
+	{
+		return ((left.first > right.first) || ((left.first == right.first) && (left.second < right.second)));
+	}
+
+	uint32_t CompletionIndex::GetLowestBit(uint32_t bits)
+	{
+#if defined(_MSC_VER)
+		unsigned long bit = 0;
+		_BitScanForward(&bit, bits);
+		return static_cast<uint32_t>(bit);
+#else
+		return static_cast<uint32_t>(__builtin_ctz(bits));
+#endif
+	}
+
+	uint32_t CompletionIndex::GetLaneCount(uint32_t lanes)
+	{
+		lanes = (lanes - ((lanes >> 1) & 0x5555));
+		lanes = ((lanes & 0x3333) + ((lanes >> 2) & 0x3333));
+		lanes = ((lanes + (lanes >> 4)) & 0x0F0F);
+		return ((lanes + (lanes >> 8)) & 0x1F);
+	}
+
+	int32_t CompletionIndex::FindChar(const char* key, uint32_t from, uint32_t length, char c)
+	{
+#if defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)) || defined(__SSE2__)
+		// Sixteen bytes at a time, "KeyPadding" makes reading past the end of the last key safe.
+		__m128i needle = _mm_set1_epi8(c);
+
+		for (uint32_t position = from; position < length; position += 16)
+		{
+			uint32_t hits = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(key + position)), needle)));
+
+			if (hits != 0)
+			{
+				position += GetLowestBit(hits);
+				return ((position < length) ? static_cast<int32_t>(position) : -1);
+			}
+		}
+
+		return -1;
+#else
+		const char* hit = ((from < length) ? static_cast<const char*>(memchr((key + from), c, (length - from))) : nullptr);
+		return (hit ? static_cast<int32_t>(hit - key) : -1);
+#endif
+	}
+
+	int32_t CompletionIndex::GetStepScore(uint32_t index, int32_t previous, int32_t position) const
+	{
+		int32_t score = 16;
+
+		if ((previous >= 0) && (position == (previous + 1)))
+		{
+			score += 24;
+		}
+		else
+		{
+			score -= std::min((position - previous - 1), 8);
+		}
+
+		if (position == 0)
+		{
+			score += 20;
+		}
+		else if (WordStarts[KeyOffsets[index] + static_cast<uint32_t>(position)])
+		{
+			score += 16;
+		}
+
+		return score;
+	}
+}
+
+ImInterface::ImInterface(const std::string& title, const std::string& name, std::function<void(std::string, bool)> toggleCallback, bool bShowCursor) :
+	WindowTitle(title),
+	ShowCursor(bShowCursor),
+	WindowName(name),
+	Attached(false),
+	ToggleCallback(toggleCallback),
+	Render(false),
+	Focused(false)
+{
+
+}
+
+ImInterface::~ImInterface()
+{
+	OnDetatch();
+}
+
+const std::string& ImInterface::GetTitle() const
+{
+	return WindowTitle;
+}
+
+const std::string& ImInterface::GetName() const
+{
+	return WindowName;
+}
+
+bool ImInterface::ShouldShowCursor() const
+{
+	return ShowCursor;
+}
+
+bool ImInterface::IsAttached() const
+{
+	return Attached;
+}
+
+bool ImInterface::ShouldRender()
+{
+	if (!Render)
+	{
+		SetShouldRender(false);
+	}
+
+	return (IsAttached() && Render);
+}
+
+bool* ImInterface::ShouldBegin()
+{
+	return &Render;
+}
+
+bool ImInterface::IsFocused() const
+{
+	return Focused;
+}
+
+void ImInterface::SetAttached(bool bAttached)
+{
+	Attached = bAttached;
+}
+
+void ImInterface::SetShouldRender(bool bShouldRender)
+{
+	Render = bShouldRender;
+
+	if (ToggleCallback)
+	{
+		ToggleCallback(WindowName, Render);
+	}
+}
+
+void ImInterface::SetIsFocused(bool bFocused)
+{
+	Focused = bFocused;
+}
+
+void ImInterface::ToggleRender()
+{
+	SetShouldRender(!Render);
+}
+
+void ImInterface::OnAttach()
+{
+	SetAttached(true);
+}
+
+void ImInterface::OnDetatch()
+{
+	if (IsAttached())
+	{
+		SetAttached(false);
+	}
+}
+
+void ImInterface::OnRender() {}
+
+ImDemo::ImDemo(const std::string& title, const std::string& name, std::function<void(std::string, bool)> toggleCallback, bool bShowCursor) : ImInterface(title, name, toggleCallback, bShowCursor) {}
+
+ImDemo::~ImDemo()
+{
+	OnDetatch();
+}
+
+void ImDemo::OnAttach()
+{
+	SetAttached(true);
+}
+
+void ImDemo::OnDetatch()
+{
+	if (IsAttached())
+	{
+		SetAttached(false);
+	}
+}
+
+void ImDemo::OnRender()
+{
+	if (ShouldRender())
+	{
+		ImGui::ShowDemoWindow(ShouldBegin());
+	}
+}
+
+ImFunctionScanner::ImFunctionScanner(const std::string& title, const std::string& name, std::function<void(std::string, bool)> toggleCallback, bool bShowCursor) : ImInterface(title, name, toggleCallback, bShowCursor) {}
+
+ImFunctionScanner::~ImFunctionScanner()
+{
+	OnDetatch();
+}
+
+void ImFunctionScanner::OnAttach()
+{
+	TableFlags = (ImGuiTableFlags_SizingFixedFit | ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_NoBordersInBody | ImGuiTableFlags_Resizable | ImGuiTableFlags_Reorderable | ImGuiTableFlags_Hideable | ImGuiTableFlags_ScrollY);
+	ScanFunctions = false;
+	EventQueue.Reserve(65536);
+	DroppedSnapshot = 0;
+	DroppedLastFrame = 0;
+	FilterGeneration = 1;
+	FilterMatcher.Compile({ &Whitelist, &Blacklist });
+	CaptureVerdicts.Reserve(MaxFilterIndex);
+	CaptureNanoseconds = 0;
+	CaptureResumed = 0;
+	DiffSecond = 0;
+	DiffDirty = true;
+	ShowBaselineDiff = true;
+	DiffChangesOnly = true;
+	BaselineFailed = false;
+	DiffThreshold = 10.0f;
+	BaselinePath[0] = '\0';
+	TimelineStart = 0.0;
+	TimelineSpan = 0.0;
+	FrameFilterBegin = 0;
+	FrameFilterEnd = 0;
+	RecordToDisk = false;
+	SortedRows = 0;
+	SortedSecond = 0;
+	RateWindows = { 1, 10, 60 };
+	TimeFunctions = false;
+	CapturePolicy = CapturePolicies::Every;
+	SampleInterval = 16;
+	TokenRate = 100;
+	TokenBuckets = std::make_unique<ImClasses::TokenBucket[]>(TokenBucketCount);
+	ReservoirRandom.seed(0x5EED);
+	ReservoirSeen = 0;
+	ReservoirSize = 100000;
+	HistoryCapMegabytes = static_cast<int32_t>(FunctionHistory.GetMemoryCap() / (1024 * 1024));
+	ImClasses::EventClock::Calibrate();
+	InvalidateRows();
+	SetAttached(true);
+}
+
+void ImFunctionScanner::OnDetatch()
+{
+	if (IsAttached())
+	{
+		StopRecording();
+		Exporter.Cancel();
+		SetAttached(false);
+	}
+}
+
+void ImFunctionScanner::OnRender()
+{
+	UpdateCaptureTime();
+	DrainEvents();
+	FrameCounter.fetch_add(1, std::memory_order_relaxed); // Overlays render once per presented frame, so this lines up with the game's own frames.
+
+	if (ShouldRender())
+	{
+		std::string newTitle = GetTitle();
+
+		if (!FunctionHistory.Empty())
+		{
+			newTitle += (" - " + (HideDuplicates ? std::to_string(FunctionMap.size()) : std::to_string(FunctionHistory.Size())) + " Functions###FunctionScanner");
+		}
+		else
+		{
+			newTitle += "###FunctionScanner";
+		}
+
+		ImGui::SetNextWindowSize(ImVec2(500.0f, 625.0f), ImGuiCond_Once);
+
+		if (ImGui::Begin(newTitle.c_str(), ShouldBegin(), ImGuiWindowFlags_NoNav))
+		{
+			SetIsFocused(ImGui::IsWindowFocused());
+
+			if (ImGui::BeginTable("###Scanner_Filter", 2))
+			{
+				ImGui::TableSetupColumn("Text", ImGuiTableColumnFlags_WidthFixed, 50.0f);
+				ImGui::TableSetupColumn("Value", ImGuiTableColumnFlags_WidthStretch);
+
+				// Whitelist
+				{
+					ImGui::TableNextRow();
+					ImGui::TableSetColumnIndex(0);
+					ImGui::TextUnformatted("Whitelist");
+					ImGui::TableSetColumnIndex(1);
+					if (Whitelist.Draw(" Filter: (\"incl\") (\"error\")###Scanner_Whitelist")) { OnFilterChanged(); }
+				}
+
+				// Blacklist
+				{
+					ImGui::TableNextRow();
+					ImGui::TableSetColumnIndex(0);
+					ImGui::TextUnformatted("Blacklist");
+					ImGui::TableSetColumnIndex(1);
+					if (Blacklist.Draw(" Filter: (\"excl\") (\"error\")###Scanner_Blacklist")) { OnFilterChanged(); }
+				}
+
+				ImGui::EndTable();
+			}
+
+			UpdateRows();
+			ImGui::Spacing();
+
+			if (IsScanning()) { if (ImGui::Button("Stop Monitoring")) { ScanFunctions = false; } }
+			else { if (ImGui::Button("Start Monitoring")) { ScanFunctions = true; } }
+
+			ImGui::SameLine(); if (ImGui::Button("Clear Table")) { ClearTable(); }
+			ImGui::SameLine(); if (ImGui::Button("Save to File")) { SaveToFile(); }
+			ImGui::SameLine(); ImGui::Checkbox("Hide duplicates###Scanner_Hide_Dupes", &HideDuplicates);
+			ImGui::SameLine(); ImGui::Checkbox("Call graph###Scanner_CallGraph", &ShowCallGraph);
+			ImGui::SameLine(); if (ImGui::Button("Export Flamegraph")) { ExportFlamegraph(); }
+			ImGui::SameLine(); ImGui::Checkbox("Timeline###Scanner_Timeline", &ShowTimeline);
+			ImGui::SameLine(); ImGui::Checkbox("Record to disk###Scanner_Record", &RecordToDisk);
+
+			bool timeFunctions = TimeFunctions;
+			ImGui::SameLine(); if (ImGui::Checkbox("Time calls###Scanner_Time", &timeFunctions)) { TimeFunctions = timeFunctions; }
+
+			{
+				static const char* policyNames[] = { "Every event", "1 in N", "Reservoir", "Per-function rate limit" };
+				int32_t policy = static_cast<int32_t>(CapturePolicy.load());
+				ImGui::SetNextItemWidth(160.0f);
+
+				if (ImGui::Combo("Capture###Scanner_Policy", &policy, policyNames, IM_ARRAYSIZE(policyNames)))
+				{
+					CapturePolicy = static_cast<CapturePolicies>(policy);
+					ReservoirSeen = FunctionHistory.Size();
+
+					if (CapturePolicy == CapturePolicies::Reservoir)
+					{
+						TrimReservoir(GetReservoirCapacity(FunctionHistory.GetMemoryCap()));
+					}
+				}
+
+				ImGui::SameLine();
+				ImGui::SetNextItemWidth(100.0f);
+
+				if (CapturePolicy == CapturePolicies::OneInN)
+				{
+					int32_t interval = static_cast<int32_t>(SampleInterval.load());
+					if (ImGui::InputInt("N###Scanner_Interval", &interval)) { SampleInterval = static_cast<uint32_t>(std::max(interval, 1)); }
+				}
+				else if (CapturePolicy == CapturePolicies::Reservoir)
+				{
+					if (ImGui::InputInt("History size###Scanner_Reservoir", &ReservoirSize, 1000, 10000))
+					{
+						ReservoirSize = std::max(ReservoirSize, 1);
+						TrimReservoir(GetReservoirCapacity(FunctionHistory.GetMemoryCap()));
+					}
+				}
+				else if (CapturePolicy == CapturePolicies::TokenBucket)
+				{
+					int32_t rate = static_cast<int32_t>(TokenRate.load());
+					if (ImGui::InputInt("Events/sec###Scanner_TokenRate", &rate, 10, 100)) { TokenRate = static_cast<uint32_t>(std::max(rate, 1)); }
+				}
+			}
+
+			ImGui::SetNextItemWidth(100.0f);
+
+			if (ImGui::InputInt("History cap (MB)###Scanner_HistoryCap", &HistoryCapMegabytes, 16, 128))
+			{
+				HistoryCapMegabytes = std::max(HistoryCapMegabytes, 1);
+				size_t memoryCap = (static_cast<size_t>(HistoryCapMegabytes) * 1024 * 1024);
+
+				// Thinned out first so the cap has nothing left to evict, it would only ever drop the oldest events.
+				if (CapturePolicy == CapturePolicies::Reservoir)
+				{
+					TrimReservoir(GetReservoirCapacity(memoryCap));
+				}
+
+				FunctionHistory.SetMemoryCap(memoryCap);
+				TrimHistoryRows();
+			}
+
+			ImGui::SameLine();
+			ImGui::TextDisabled("%.1f MB used, %zu events retained, %llu evicted.", (FunctionHistory.GetBytes() / (1024.0 * 1024.0)), FunctionHistory.Size(), static_cast<unsigned long long>(FunctionHistory.GetEvicted()));
+
+			ImGui::SetNextItemWidth(150.0f);
+
+			if (ImGui::InputInt3("Rate windows (s)###Scanner_RateWindows", RateWindows.data()))
+			{
+				for (int32_t& window : RateWindows) { window = std::clamp(window, 1, static_cast<int32_t>(ImClasses::FunctionRate::HistorySeconds)); }
+				SortedSecond = 0; // Re-sorts next frame if a rate column is sorted on.
+			}
+
+			if (DiskRecorder.IsActive())
+			{
+				ImGui::TextDisabled("Recording, %llu events written, %llu dropped.", static_cast<unsigned long long>(DiskRecorder.GetRecordsWritten()), static_cast<unsigned long long>(DiskRecorder.GetRecordsDropped()));
+			}
+
+			if (FileWriter.IsActive())
+			{
+				ImGui::TextDisabled("Saving, %llu events written.", static_cast<unsigned long long>(FileWriter.GetRecordsWritten()));
+			}
+
+			if (Exporter.IsRunning())
+			{
+				size_t rowCount = std::max<size_t>(Exporter.GetRowCount(), 1);
+				std::string progressText = ("Exporting " + std::to_string(Exporter.GetRowsWritten()) + " / " + std::to_string(Exporter.GetRowCount()) + " rows");
+				ImGui::ProgressBar((static_cast<float>(Exporter.GetRowsWritten()) / rowCount), ImVec2(300.0f, 0.0f), progressText.c_str());
+				ImGui::SameLine(); if (ImGui::Button("Cancel Export")) { Exporter.Cancel(); }
+			}
+			else
+			{
+				std::string clipboardText;
+
+				if (Exporter.Finish(clipboardText))
+				{
+					ImGui::SetClipboardText(clipboardText.c_str());
+				}
+			}
+
+			ImGui::SetNextItemWidth(260.0f);
+			ImGui::InputTextWithHint("###Scanner_BaselinePath", "Baseline capture (.bin)", BaselinePath, IM_ARRAYSIZE(BaselinePath));
+			ImGui::SameLine(); if (ImGui::Button("Load Baseline")) { LoadBaseline(BaselinePath); }
+
+			if (Baseline.IsOpen())
+			{
+				ImGui::SameLine(); if (ImGui::Button("Clear Baseline")) { ClearBaseline(); }
+				ImGui::SameLine(); ImGui::Checkbox("Diff###Scanner_ShowDiff", &ShowBaselineDiff);
+				ImGui::SameLine(); if (ImGui::Checkbox("Changes only###Scanner_DiffChanges", &DiffChangesOnly)) { DiffDirty = true; }
+				ImGui::SameLine(); ImGui::SetNextItemWidth(80.0f);
+				if (ImGui::InputFloat("Threshold %###Scanner_DiffThreshold", &DiffThreshold, 0.0f, 0.0f, "%.0f")) { DiffThreshold = std::max(DiffThreshold, 0.0f); DiffDirty = true; }
+				ImGui::SameLine();
+
+				if (Baseline.GetDuration() != 0)
+				{
+					ImGui::TextDisabled("%zu baseline functions over %.1fs.", Baseline.GetFunctionCount(), (Baseline.GetDuration() / 1000000000.0));
+				}
+				else
+				{
+					ImGui::TextDisabled("%zu baseline functions, unknown duration.", Baseline.GetFunctionCount());
+				}
+			}
+			else if (BaselineFailed)
+			{
+				ImGui::SameLine(); ImExtensions::TextColored("Not a valid capture file.", ImColorMap[TextColors::Red]);
+			}
+
+			if (DroppedSnapshot > 0)
+			{
+				ImExtensions::TextColored(("Dropped " + std::to_string(DroppedSnapshot) + " events (" + std::to_string(DroppedLastFrame) + " last frame), the capture ring is full.").c_str(), ImColorMap[TextColors::Red]);
+			}
+
+			if (FrameFilterEnd != 0)
+			{
+				ImGui::TextDisabled("History limited to frames %u - %u.", FrameFilterBegin, (FrameFilterEnd - 1));
+				ImGui::SameLine(); if (ImGui::SmallButton("Show all frames")) { SetFrameFilter(0, 0); }
+			}
+
+			ImGui::Spacing();
+
+			if (ShowTimeline)
+			{
+				RenderTimeline();
+				ImGui::Spacing();
+			}
+
+			if (ShowCallGraph)
+			{
+				if (ImGui::BeginChild("###FunctionScanner_CallGraph"))
+				{
+					if (FunctionGraph.Size() == 0)
+					{
+						ImGui::TextDisabled("No calls recorded yet.");
+					}
+
+					RenderCallGraph(ImClasses::CallGraph::RootNode);
+				}
+
+				ImGui::EndChild();
+			}
+			else if (HideDuplicates)
+			{
+				bool showDiff = (ShowBaselineDiff && Baseline.IsOpen());
+				ImVec2 tableSize(0.0f, (showDiff ? (ImGui::GetContentRegionAvail().y * 0.5f) : 0.0f));
+
+				if (ImGui::BeginTable("###FunctionScanner_Duplicate_Table", static_cast<int32_t>(FunctionColumns::END), (TableFlags | ImGuiTableFlags_Sortable), tableSize))
+				{
+					if (ImGui::BeginPopupContextWindow())
+					{
+						if (ImGui::Selectable("Copy to Clipboard")) { ExportTable(ExportFormats::Clipboard, true); }
+						if (ImGui::Selectable("Export to CSV")) { ExportTable(ExportFormats::Csv, true); }
+						if (ImGui::Selectable("Export to JSON Lines")) { ExportTable(ExportFormats::JsonLines, true); }
+						ImGui::EndPopup();
+					}
+
+					ImGui::TableSetupScrollFreeze(0, 1);
+					ImGui::TableSetupColumn("Calls", (ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_PreferSortDescending), 20.0f, static_cast<ImGuiID>(FunctionColumns::Calls));
+					ImGui::TableSetupColumn("Package Object", ImGuiTableColumnFlags_WidthFixed, 100.0f, static_cast<ImGuiID>(FunctionColumns::Package));
+					ImGui::TableSetupColumn("Calling Class", ImGuiTableColumnFlags_WidthStretch, 0.0f, static_cast<ImGuiID>(FunctionColumns::Caller));
+					ImGui::TableSetupColumn("Function Name", ImGuiTableColumnFlags_WidthStretch, 0.0f, static_cast<ImGuiID>(FunctionColumns::Function));
+					ImGui::TableSetupColumn("Total", (ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_PreferSortDescending), 60.0f, static_cast<ImGuiID>(FunctionColumns::TotalTime));
+					ImGui::TableSetupColumn("Avg", (ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_PreferSortDescending), 60.0f, static_cast<ImGuiID>(FunctionColumns::AverageTime));
+					ImGui::TableSetupColumn("p99", (ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_PreferSortDescending), 60.0f, static_cast<ImGuiID>(FunctionColumns::P99Time));
+					ImGui::TableSetupColumn("Max", (ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_PreferSortDescending), 60.0f, static_cast<ImGuiID>(FunctionColumns::MaxTime));
+
+					for (size_t i = 0; i < RateWindows.size(); i++)
+					{
+						std::string rateLabel = ("/s (" + std::to_string(RateWindows[i]) + "s)");
+						ImGui::TableSetupColumn(rateLabel.c_str(), (ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_PreferSortDescending), 50.0f, (static_cast<ImGuiID>(FunctionColumns::RateWindow1) + static_cast<ImGuiID>(i)));
+					}
+
+					ImGui::TableSetupColumn("Last 60s", (ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_NoSort), 90.0f, static_cast<ImGuiID>(FunctionColumns::RateHistory));
+					ImGui::TableHeadersRow();
+
+					if (ImGuiTableSortSpecs* sortSpecs = ImGui::TableGetSortSpecs())
+					{
+						bool rateChanged = ((SortedSecond != GetCurrentSecond()) && IsSortedByStats(sortSpecs));
+
+						if (sortSpecs->SpecsDirty || rateChanged || (SortedRows != FunctionRows.size()) || !ChangedSlots.empty())
+						{
+							SortFunctionRows(sortSpecs, (sortSpecs->SpecsDirty || rateChanged));
+							sortSpecs->SpecsDirty = false;
+						}
+					}
+
+					// Only the visible rows are submitted, the filter was already applied when "FunctionRows" was built.
+					uint64_t nowSecond = GetCurrentSecond();
+					ImGuiListClipper clipper;
+					clipper.Begin(static_cast<int32_t>(FunctionRows.size()));
+
+					while (clipper.Step())
+					{
+						for (int32_t row = clipper.DisplayStart; row < clipper.DisplayEnd; row++)
+						{
+							uint32_t slot = FunctionRows[row];
+							const ImClasses::FunctionCount& data = FunctionMap[slot];
+
+							ImGui::TableNextRow();
+							ImGui::TableSetColumnIndex(0);
+							ImGui::Text("%zu", data.Calls);
+							ImGui::TableSetColumnIndex(1);
+							ImGui::TextUnformatted(data.GetPackage().c_str());
+							ImGui::TableSetColumnIndex(2);
+							ImGui::TextUnformatted(data.GetCaller().c_str());
+							ImGui::TableSetColumnIndex(3);
+							ImGui::TextUnformatted(data.GetFunction().c_str());
+
+							if ((slot < FunctionTimings.size()) && (FunctionTimings[slot].Samples > 0))
+							{
+								const ImClasses::FunctionTiming& timing = FunctionTimings[slot];
+								char timeText[32];
+
+								ImClasses::FunctionTiming::FormatTime(timeText, sizeof(timeText), timing.Total);
+								ImGui::TableSetColumnIndex(4);
+								ImGui::TextUnformatted(timeText);
+								ImClasses::FunctionTiming::FormatTime(timeText, sizeof(timeText), timing.GetAverage());
+								ImGui::TableSetColumnIndex(5);
+								ImGui::TextUnformatted(timeText);
+								ImClasses::FunctionTiming::FormatTime(timeText, sizeof(timeText), timing.GetPercentile(0.99));
+								ImGui::TableSetColumnIndex(6);
+								ImGui::TextUnformatted(timeText);
+								ImClasses::FunctionTiming::FormatTime(timeText, sizeof(timeText), timing.Max);
+								ImGui::TableSetColumnIndex(7);
+								ImGui::TextUnformatted(timeText);
+							}
+
+							const ImClasses::FunctionRate& rate = FunctionRates[slot];
+							float history[ImClasses::FunctionRate::HistorySeconds];
+
+							for (size_t i = 0; i < RateWindows.size(); i++)
+							{
+								ImGui::TableSetColumnIndex(static_cast<int32_t>(8 + i));
+								ImGui::Text("%.1f", rate.GetRate(nowSecond, static_cast<size_t>(RateWindows[i])));
+							}
+
+							if (ImGui::TableSetColumnIndex(11))
+							{
+								rate.GetHistory(nowSecond, history);
+								ImGui::PushID(static_cast<int32_t>(slot));
+								ImGui::PlotLines("###Scanner_RateHistory", history, static_cast<int32_t>(ImClasses::FunctionRate::HistorySeconds), 0, nullptr, 0.0f, FLT_MAX, ImVec2(-FLT_MIN, ImGui::GetTextLineHeight()));
+								ImGui::PopID();
+							}
+						}
+					}
+
+					ImGui::EndTable();
+				}
+
+				if (showDiff)
+				{
+					RenderBaselineDiff();
+				}
+			}
+			else
+			{
+				if (ImGui::BeginTable("###FunctionScanner_Default_Table", 4, TableFlags))
+				{
+					if (ImGui::BeginPopupContextWindow())
+					{
+						if (ImGui::Selectable("Copy to Clipboard")) { ExportTable(ExportFormats::Clipboard, false); }
+						if (ImGui::Selectable("Export to CSV")) { ExportTable(ExportFormats::Csv, false); }
+						if (ImGui::Selectable("Export to JSON Lines")) { ExportTable(ExportFormats::JsonLines, false); }
+						ImGui::EndPopup();
+					}
+
+					ImGui::TableSetupColumn("Frame", ImGuiTableColumnFlags_WidthFixed, 50.0f);
+					ImGui::TableSetupColumn("Package Object", ImGuiTableColumnFlags_WidthFixed, 100.0f);
+					ImGui::TableSetupColumn("Calling Class", ImGuiTableColumnFlags_WidthStretch);
+					ImGui::TableSetupColumn("Function Name", ImGuiTableColumnFlags_WidthStretch);
+					ImGui::TableHeadersRow();
+
+					ImGuiListClipper clipper;
+					clipper.Begin(static_cast<int32_t>(HistoryRows.size()));
+
+					while (clipper.Step())
+					{
+						for (int32_t row = clipper.DisplayStart; row < clipper.DisplayEnd; row++)
+						{
+							const ImClasses::FunctionData& data = FunctionHistory[HistoryRows[row]];
+
+							ImGui::TableNextRow();
+							ImGui::TableSetColumnIndex(0);
+							ImGui::Text("%u", data.Frame);
+							ImGui::TableSetColumnIndex(1);
+							ImGui::TextUnformatted(data.GetPackage().c_str());
+							ImGui::TableSetColumnIndex(2);
+							ImGui::TextUnformatted(data.GetCaller().c_str());
 							ImGui::TableSetColumnIndex(3);
-							ImGui::TextUnformatted(data.Function.c_str());
+							ImGui::TextUnformatted(data.GetFunction().c_str());
+						}
+					}
+
+					ImGui::EndTable();
+				}
+			}
+		}
+		else
+		{
+			SetShouldRender(false);
+			ScanFunctions = false;
+		}
+
+		ImGui::End();
+	}
+	else
+	{
+		ScanFunctions = false;
+	}
+}
+
+bool ImFunctionScanner::IsScanning()
+{
+	return ScanFunctions;
+}
+
+void ImFunctionScanner::SaveToFile()
+{
+	if (!FunctionHistory.Empty() && FileWriter.Open("FunctionCapture_" + std::to_string(std::time(nullptr)) + ".bin"))
+	{
+		// Only block references are handed over, the writer thread converts the records and does all of the file IO.
+		FileWriter.Submit(FunctionHistory.Share());
+		FileWriter.Close(FunctionMap, GetSessionDuration());
+	}
+}
+
+void ImFunctionScanner::ExportTable(ExportFormats format, bool bFunctionTable)
+{
+	if (Exporter.IsRunning())
+	{
+		return;
+	}
+
+	// Only raw copies and block references are taken here, in the order the table currently shows them. Stats, lookups, and formatting are all left to the export thread.
+	std::string filePath;
+
+	if (format == ExportFormats::Csv)
+	{
+		filePath = ("FunctionExport_" + std::to_string(std::time(nullptr)) + ".csv");
+	}
+	else if (format == ExportFormats::JsonLines)
+	{
+		filePath = ("FunctionExport_" + std::to_string(std::time(nullptr)) + ".jsonl");
+	}
+
+	if (!bFunctionTable)
+	{
+		Exporter.Start(format, filePath, FunctionHistory.Share(), std::vector<uint64_t>(HistoryRows.begin(), HistoryRows.end()), FunctionHistory.GetFirstId());
+		return;
+	}
+
+	std::vector<ImClasses::FunctionData> rows;
+	std::vector<ImClasses::ExportStats> stats;
+	rows.reserve(FunctionRows.size());
+
+	if (format != ExportFormats::Clipboard)
+	{
+		stats.reserve(FunctionRows.size());
+	}
+
+	for (uint32_t slot : FunctionRows)
+	{
+		rows.push_back(FunctionMap[slot]);
+
+		if (format != ExportFormats::Clipboard)
+		{
+			ImClasses::ExportStats functionStats;
+			functionStats.Calls = FunctionMap[slot].Calls;
+			functionStats.Rate = FunctionRates[slot];
+
+			if (slot < FunctionTimings.size())
+			{
+				functionStats.Timing = FunctionTimings[slot];
+			}
+
+			stats.push_back(functionStats);
+		}
+	}
+
+	std::array<uint32_t, 3> rateWindows = { static_cast<uint32_t>(RateWindows[0]), static_cast<uint32_t>(RateWindows[1]), static_cast<uint32_t>(RateWindows[2]) };
+	Exporter.Start(format, filePath, std::move(rows), std::move(stats), GetCurrentSecond(), rateWindows);
+}
+
+void ImFunctionScanner::ExportFlamegraph()
+{
+	// Only the node list is copied here, folding it and the file write happen on the export thread.
+	if ((FunctionGraph.Size() > 0) && !Exporter.IsRunning())
+	{
+		Exporter.Start(("FunctionFlamegraph_" + std::to_string(std::time(nullptr)) + ".folded"), std::vector<ImClasses::CallGraph::Node>(FunctionGraph.GetNodes()));
+	}
+}
+
+bool ImFunctionScanner::LoadBaseline(const std::string& filePath)
+{
+	ClearBaseline();
+
+	if (!Baseline.Open(filePath))
+	{
+		BaselineFailed = true;
+		return false;
+	}
+
+	// Build side of the hash join, full names are the only identity that survives between sessions since object indices don't.
+	const ImClasses::CaptureFunction* functions = Baseline.GetFunctions();
+	BaselineRows.reserve(Baseline.GetFunctionCount());
+
+	for (size_t row = 0; row < Baseline.GetFunctionCount(); row++)
+	{
+		BaselineRows.emplace(Baseline.GetFullName(functions[row].FullName), static_cast<uint32_t>(row));
+	}
+
+	return true;
+}
+
+void ImFunctionScanner::ClearBaseline()
+{
+	Baseline.Close();
+	BaselineRows.clear();
+	BaselineMatches.clear();
+	DiffRows.clear();
+	BaselineFailed = false;
+	DiffDirty = true;
+}
+
+uint64_t ImFunctionScanner::GetSessionDuration() const
+{
+	return CaptureNanoseconds;
+}
+
+void ImFunctionScanner::UpdateCaptureTime()
+{
+	uint64_t now = ImClasses::EventClock::Now();
+
+	if (CaptureResumed != 0)
+	{
+		CaptureNanoseconds += ImClasses::EventClock::ToNanoseconds(now - CaptureResumed);
+	}
+
+	CaptureResumed = (IsScanning() ? now : 0);
+}
+
+void ImFunctionScanner::StartRecording()
+{
+	if (!DiskRecorder.IsActive() && !DiskRecorder.Open("FunctionRecording_" + std::to_string(std::time(nullptr)) + ".bin"))
+	{
+		RecordToDisk = false;
+	}
+}
+
+void ImFunctionScanner::StopRecording()
+{
+	DiskRecorder.Close(FunctionMap, GetSessionDuration());
+}
+
+void ImFunctionScanner::ClearTable()
+{
+	StopRecording(); // Name IDs are about to be reset, so the current recording can't continue past this point.
+	Exporter.Cancel(); // Same for an export, it reads the name tables.
+	DiskRecorder.DetachNames(); // Closing writers only hold views of the names, they get their own copies if they still need them.
+	FileWriter.DetachNames();
+	CaptureNanoseconds = 0;
+	CaptureResumed = 0;
+	BaselineMatches.clear();
+	DiffDirty = true;
+	FunctionMap.clear();
+	FunctionTimings.clear();
+	FunctionRates.clear();
+	FunctionGraph.Clear();
+	FrameCalls.Clear();
+	TimelineStart = 0.0;
+	TimelineSpan = 0.0;
+	FrameFilterBegin = 0;
+	FrameFilterEnd = 0;
+	ChangedSlots.clear();
+	ChangedFlags.clear();
+	RowPositions.clear();
+	FunctionSlots.Clear();
+	FunctionHistory.Clear();
+	ImClasses::FunctionData::ClearNames();
+	ReservoirSeen = 0;
+	VerdictSlots.Clear();
+	FilterVerdicts.clear();
+	CaptureVerdicts.Clear();
+	InvalidateRows();
+	EventQueue.ResetDropped();
+	DroppedSnapshot = 0;
+	DroppedLastFrame = 0;
+}
+
+bool ImFunctionScanner::PassesFilter(std::string_view textToFilter)
+{
+	// One pass over the text for both filters, bit zero is the whitelist and bit one the blacklist.
+	uint32_t passed = FilterMatcher.Match(textToFilter.data(), textToFilter.size());
+	return ((passed & 1) && !(Blacklist.IsActive() && (passed & 2)));
+}
+
+bool ImFunctionScanner::PassesFilter(const ImClasses::FunctionData& functionData)
+{
+	// Names repeat millions of times, so each distinct function only runs the text filters once per filter generation.
+	bool inserted = false;
+	uint32_t slot = VerdictSlots.FindOrInsert(functionData.Index, static_cast<uint32_t>(FilterVerdicts.size()), inserted);
+
+	if (inserted)
+	{
+		FilterVerdicts.push_back(0);
+	}
+
+	uint32_t& verdict = FilterVerdicts[slot];
+
+	if ((verdict >> 1) != FilterGeneration)
+	{
+		verdict = ((FilterGeneration << 1) | (PassesFilter(functionData.GetFullName()) ? 1 : 0));
+		CaptureVerdicts.Set(functionData.Index, ((verdict & 1) ? FilterStates::Accepted : FilterStates::Rejected));
+	}
+
+	return (verdict & 1);
+}
+
+void ImFunctionScanner::OnFilterChanged()
+{
+	FilterMatcher.Compile({ &Whitelist, &Blacklist });
+	CaptureVerdicts.Clear(); // Producers may keep dropping by the old verdicts until the end of this call, at most a frame's worth of events.
+	FilterGeneration++;
+	InvalidateRows();
+	DiffDirty = true;
+}
+
+ImNotification::ImNotification(const std::string& title, const std::string& name) : ImInterface(title, name, NULL, false) {}
+
+ImNotification::~ImNotification() { OnDetatch(); }
+
+void ImNotification::OnAttach()
+{
+	WindowPadding = 10.0f;
+	WindowOffset = 0.0f;
+	Corner = CornerPositions::TopLeft;
+	WindowFlags = (ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoNav | ImGuiWindowFlags_NoInputs);
+	DescriptionColor = ImColorMap[TextColors::White];
+	DeltaTime = 0.0f;
+	CutoffTime = 300.0f;
+	BaseAlpha = 0.85f;
+	LastAlpha = BaseAlpha;
+	FadeOut = false;
+	SetAttached(true);
+}
+
+void ImNotification::OnDetatch()
+{
+	if (IsAttached())
+	{
+		SetAttached(false);
+	}
+}
+
+void ImNotification::OnRender()
+{
+	if (ShouldRender())
+	{
+		if (!FadeOut && (DeltaTime > CutoffTime))
+		{
+			DeltaTime = 0.0f;
+			LastAlpha = BaseAlpha;
+			TitleColor.w = LastAlpha;
+			DescriptionColor.w = LastAlpha;
+			FadeOut = true;
+		}
+		else if (FadeOut && (LastAlpha < 0.0f))
+		{
+			DeltaTime = 0.0f;
+			LastAlpha = BaseAlpha;
+			TitleColor.w = LastAlpha;
+			DescriptionColor.w = LastAlpha;
+			FadeOut = false;
+			SetShouldRender(false);
+			return;
+		}
+
+		ImGuiViewport* viewport = ImGui::GetMainViewport();
+		ImVec2 work_pos = viewport->WorkPos;
+		ImVec2 work_size = viewport->WorkSize;
+		ImVec2 window_pos;
+		ImVec2 window_pos_pivot;
+
+		window_pos.x = (Corner == CornerPositions::TopRight || Corner == CornerPositions::BottomRight) ? (work_pos.x + work_size.x - WindowPadding) : (work_pos.x + WindowPadding);
+		window_pos.y = (Corner == CornerPositions::BottomRight || Corner == CornerPositions::BottomLeft) ? (work_pos.y + work_size.y - WindowPadding) : (work_pos.y + WindowPadding);
+		window_pos_pivot.x = (Corner == CornerPositions::TopRight || Corner == CornerPositions::BottomRight) ? 1.0f : 0.0f;
+		window_pos_pivot.y = (Corner == CornerPositions::BottomRight || Corner == CornerPositions::BottomLeft) ? 1.0f : 0.0f;
+		
+		if (Corner == CornerPositions::TopLeft) { window_pos.y += WindowOffset; }
+		else if (Corner == CornerPositions::TopRight) { window_pos.y += WindowOffset; }
+		else if (Corner == CornerPositions::BottomLeft) { window_pos.y -= WindowOffset; }
+		else if (Corner == CornerPositions::BottomRight) { window_pos.y -= WindowOffset; }
+
+		ImGui::SetNextWindowPos(window_pos, ImGuiCond_Always, window_pos_pivot);
+		ImGui::SetNextWindowSize(ImVec2(325.0f, 75.0f), ImGuiCond_Always);
+
+		if (FadeOut)
+		{
+			LastAlpha -= (GetRenderTime() / 100.0f);
+			ImGui::SetNextWindowBgAlpha(LastAlpha);
+		}
+		else
+		{
+			ImGui::SetNextWindowBgAlpha(BaseAlpha);
+		}
+
+		if (ImGui::Begin(GetTitle().c_str(), ShouldBegin(), WindowFlags))
+		{
+			SetIsFocused(ImGui::IsWindowFocused());
+
+			if (ImGui::BeginChild(std::string("###" + GetName() + "_Notification_ScrollRegion").c_str()))
+			{
+				TitleColor.w = LastAlpha;
+				DescriptionColor.w = LastAlpha;
+
+				ImExtensions::TextStyled(Title.c_str(), TitleColor, ImFontMap[TextStyles::Bold]);
+				ImGui::PushTextWrapPos(ImGui::GetWindowWidth() - 1.0f);
+				ImExtensions::TextStyled(Description.c_str(), DescriptionColor, ImFontMap[TextStyles::Regular]);
+				ImGui::PopTextWrapPos();
+			}
+
+			DeltaTime += GetRenderTime();
+		}
+
+		ImGui::End();
+	}
+}
+
+float ImNotification::GetRenderTime() const
+{
+	float framerate = ImGui::GetIO().Framerate;
+	if (framerate <= 15) { framerate = 4.0f; }
+	if (framerate <= 30) { framerate = 2.0f; }
+	else if (framerate <= 60) { framerate = 1.0f; }
+	else if (framerate <= 120) { framerate = 0.5f; }
+	else if (framerate <= 144) { framerate = 0.4167f; }
+	else if (framerate <= 240) { framerate = 0.25f; }
+	else if (framerate <= 360) { framerate = 0.1667f; }
+	else if (framerate <= 480) { framerate = 0.125f; }
+	else if (framerate > 480) { framerate = 0.1f; }
+	return framerate;
+}
+
+ImNotification* ImNotification::SetInformation(const std::string& title, const std::string& description, TextColors color, CornerPositions corner)
+{
+	SetTitle(title);
+	SetDescription(description);
+	SetColor(color);
+	SetPosition(corner);
+	return this;
+}
 
-							if (copy_to_clipboard)
-							{
-								ClipboardText += data.FullName;
-								ClipboardText += "\n";
-							}
-						}
-					}
+ImNotification* ImNotification::SetTitle(const std::string& title)
+{
+	Title = title;
+	return this;
+}
+
+ImNotification* ImNotification::SetDescription(const std::string& description)
+{
+	Description = description;
+	return this;
+}
+
+ImNotification* ImNotification::SetColor(TextColors color)
+{
+	TitleColor = ImColorMap[color];
+	TitleColor.w = LastAlpha;
+	return this;
+}
+
+ImNotification* ImNotification::SetPosition(CornerPositions corner)
+{
+	Corner = corner;
+	return this;
+}
+
+ImNotification* ImNotification::SetOffset(float offset)
+{
+	WindowOffset = offset;
+	return this;
+}
+
+ImNotificationManager::ImNotificationManager(const std::string& title, const std::string& name, std::function<void(std::string, bool)> toggleCallback) : ImInterface(title, name, toggleCallback, false) {}
+
+ImNotificationManager::~ImNotificationManager() { OnDetatch(); }
+
+void ImNotificationManager::OnAttach()
+{
+	// Create notifications here for them to be properly managed, rendering for them is called in the managers "OnRender" function.
+	CreateNotification(new ImNotification("Example Notification", "example_notification"))->SetInformation("This is an example", "This is an example description!", TextColors::Green);
+	SetAttached(true);
+}
+
+void ImNotificationManager::OnDetatch()
+{
+	if (IsAttached())
+	{
+		ActiveNotifications.clear();
+
+		for (auto& notification : CreatedNotifications)
+		{
+			if (notification.second)
+			{
+				notification.second->OnDetatch();
+			}
+		}
+
+		CreatedNotifications.clear();
+		SetAttached(false);
+	}
+}
+
+void ImNotificationManager::OnRender()
+{
+	if (!ActiveNotifications.empty())
+	{
+		for (auto notificationIt = ActiveNotifications.begin(); notificationIt != ActiveNotifications.end();)
+		{
+			if (*notificationIt && !(*notificationIt)->ShouldRender())
+			{
+				notificationIt = ActiveNotifications.erase(notificationIt);
+			}
+			else
+			{
+				notificationIt++;
+			}
+		}
+	}
+
+	for (const auto& notification : CreatedNotifications)
+	{
+		if (notification.second && notification.second->ShouldRender())
+		{
+			bool alreadyActive = false;
+
+			for (const auto& activeNotification : ActiveNotifications)
+			{
+				if (activeNotification == notification.second)
+				{
+					alreadyActive = true;
+					break;
+				}
+			}
+
+			if (!alreadyActive)
+			{
+				ActiveNotifications.push_back(notification.second);
+			}
+		}
+	}
+
+	if (!ActiveNotifications.empty())
+	{
+		for (size_t i = 0; i < ActiveNotifications.size(); i++)
+		{
+			std::shared_ptr<ImNotification> notification = ActiveNotifications[i];
+
+			if (notification)
+			{
+				float offset = 0.0f;
+
+				if (i != 0)
+				{
+					offset = (i * 85.0f); // 85 being the notification's window height (75) plus padding (10).
+				}
+
+				notification->SetOffset(offset);
+				notification->OnRender();
+			}
+		}
+	}
+}
+
+void ImNotificationManager::ToggleNotification(const std::string& windowName)
+{
+	std::shared_ptr<ImNotification> notification = GetNotification(windowName);
+
+	if (notification)
+	{
+		notification->ToggleRender();
+	}
+}
+
+std::shared_ptr<ImNotification> ImNotificationManager::GetNotification(const std::string& windowName)
+{
+	if (CreatedNotifications.find(windowName) != CreatedNotifications.end())
+	{
+		return CreatedNotifications[windowName];
+	}
+
+	return nullptr;
+}
+
+std::shared_ptr<ImNotification> ImNotificationManager::CreateNotification(ImNotification* notification)
+{
+	if (notification)
+	{
+		std::string notificationName = notification->GetName();
+
+		if (CreatedNotifications.find(notificationName) == CreatedNotifications.end())
+		{
+			CreatedNotifications.emplace(notificationName, std::shared_ptr<ImNotification>(notification)).first->second->OnAttach();
+			return CreatedNotifications[notificationName];
+		}
+	}
+
+	return nullptr;
+}
+
+void ImFunctionScanner::InvalidateRows()
+{
+	HistoryRows.clear();
+	FunctionRows.clear();
+	HistoryScanned = 0;
+	FunctionsScanned = 0;
+	SortedRows = 0;
+}
+
+void ImFunctionScanner::TrimHistoryRows()
+{
+	// Evicted IDs can only ever be at the front, so this never touches more than what was just evicted.
+	while (!HistoryRows.empty() && !FunctionHistory.Contains(HistoryRows.front()))
+	{
+		HistoryRows.pop_front();
+	}
+}
+
+void ImFunctionScanner::PatchHistoryRow(uint64_t id)
+{
+	// Not scanned yet, "UpdateRows" will pick it up with everything else.
+	if (id >= HistoryScanned)
+	{
+		return;
+	}
+
+	std::deque<uint64_t>::iterator rowIt = std::lower_bound(HistoryRows.begin(), HistoryRows.end(), id);
+	bool hasRow = ((rowIt != HistoryRows.end()) && (*rowIt == id));
+	const ImClasses::FunctionData& functionData = FunctionHistory[id];
+	bool passes = (PassesFrameFilter(functionData) && PassesFilter(functionData));
+
+	if (passes && !hasRow)
+	{
+		HistoryRows.insert(rowIt, id);
+	}
+	else if (!passes && hasRow)
+	{
+		HistoryRows.erase(rowIt);
+	}
+}
+
+void ImFunctionScanner::UpdateRows()
+{
+	// Rows are only ever appended, so only the new ones need to be checked unless the filter text changed.
+	TrimHistoryRows();
+
+	for (HistoryScanned = std::max(HistoryScanned, FunctionHistory.GetFirstId()); HistoryScanned < FunctionHistory.GetEndId(); HistoryScanned++)
+	{
+		const ImClasses::FunctionData& functionData = FunctionHistory[HistoryScanned];
+
+		if (PassesFrameFilter(functionData) && PassesFilter(functionData))
+		{
+			HistoryRows.push_back(HistoryScanned);
+		}
+	}
+
+	for (; FunctionsScanned < FunctionMap.size(); FunctionsScanned++)
+	{
+		if (PassesFilter(FunctionMap[FunctionsScanned]))
+		{
+			FunctionRows.push_back(static_cast<uint32_t>(FunctionsScanned));
+		}
+	}
+}
+
+void ImFunctionScanner::MarkFunctionChanged(uint32_t slot)
+{
+	if (ChangedFlags.size() <= slot)
+	{
+		ChangedFlags.resize(FunctionMap.size(), 0);
+	}
+
+	if (!ChangedFlags[slot])
+	{
+		ChangedFlags[slot] = 1;
+		ChangedSlots.push_back(slot);
+	}
+}
+
+bool ImFunctionScanner::IsSortedByStats(const ImGuiTableSortSpecs* sortSpecs) const
+{
+	// Package, caller, and function names never change once a row exists, everything else does.
+	for (int32_t i = 0; i < sortSpecs->SpecsCount; i++)
+	{
+		FunctionColumns column = static_cast<FunctionColumns>(sortSpecs->Specs[i].ColumnUserID);
+
+		if ((column != FunctionColumns::Package) && (column != FunctionColumns::Caller) && (column != FunctionColumns::Function))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool ImFunctionScanner::FunctionRowLess(const ImGuiTableSortSpecs* sortSpecs, uint64_t nowSecond, uint32_t left, uint32_t right) const
+{
+	static const ImClasses::FunctionTiming emptyTiming;
+	const ImClasses::FunctionCount& leftData = FunctionMap[left];
+	const ImClasses::FunctionCount& rightData = FunctionMap[right];
+	const ImClasses::FunctionTiming& leftTiming = ((left < FunctionTimings.size()) ? FunctionTimings[left] : emptyTiming);
+	const ImClasses::FunctionTiming& rightTiming = ((right < FunctionTimings.size()) ? FunctionTimings[right] : emptyTiming);
+
+	auto compare = [](auto leftValue, auto rightValue) -> int32_t { return ((leftValue < rightValue) ? -1 : (leftValue > rightValue)); };
+
+	for (int32_t i = 0; i < sortSpecs->SpecsCount; i++)
+	{
+		const ImGuiTableColumnSortSpecs& spec = sortSpecs->Specs[i];
+		int32_t delta = 0;
+
+		switch (static_cast<FunctionColumns>(spec.ColumnUserID))
+		{
+		case FunctionColumns::Calls: delta = compare(leftData.Calls, rightData.Calls); break;
+		case FunctionColumns::Package: delta = leftData.GetPackage().compare(rightData.GetPackage()); break;
+		case FunctionColumns::Caller: delta = leftData.GetCaller().compare(rightData.GetCaller()); break;
+		case FunctionColumns::Function: delta = leftData.GetFunction().compare(rightData.GetFunction()); break;
+		case FunctionColumns::TotalTime: delta = compare(leftTiming.Total, rightTiming.Total); break;
+		case FunctionColumns::AverageTime: delta = compare(leftTiming.GetAverage(), rightTiming.GetAverage()); break;
+		case FunctionColumns::P99Time: delta = compare(leftTiming.GetPercentile(0.99), rightTiming.GetPercentile(0.99)); break;
+		case FunctionColumns::MaxTime: delta = compare(leftTiming.Max, rightTiming.Max); break;
+		case FunctionColumns::RateWindow1:
+		case FunctionColumns::RateWindow2:
+		case FunctionColumns::RateWindow3:
+		{
+			size_t window = static_cast<size_t>(RateWindows[spec.ColumnUserID - static_cast<ImGuiID>(FunctionColumns::RateWindow1)]);
+			delta = compare(FunctionRates[left].GetRate(nowSecond, window), FunctionRates[right].GetRate(nowSecond, window));
+			break;
+		}
+		default: break;
+		}
+
+		if (delta != 0)
+		{
+			return ((spec.SortDirection == ImGuiSortDirection_Ascending) ? (delta < 0) : (delta > 0));
+		}
+	}
+
+	return (left < right);
+}
+
+void ImFunctionScanner::SortFunctionRows(const ImGuiTableSortSpecs* sortSpecs, bool bFullSort)
+{
+	if (!sortSpecs || (sortSpecs->SpecsCount <= 0))
+	{
+		for (uint32_t slot : ChangedSlots) { ChangedFlags[slot] = 0; }
+		ChangedSlots.clear();
+		SortedRows = FunctionRows.size();
+		return;
+	}
+
+	uint64_t nowSecond = GetCurrentSecond();
+	auto less = [&](uint32_t left, uint32_t right) { return FunctionRowLess(sortSpecs, nowSecond, left, right); };
+
+	// Sorted by names only, a row's stats changing can't move it so only the appended rows need placing.
+	if (!IsSortedByStats(sortSpecs))
+	{
+		for (uint32_t slot : ChangedSlots) { ChangedFlags[slot] = 0; }
+		ChangedSlots.clear();
+	}
+
+	// Appended rows are placed the same way as changed ones, flagged so the searches below skip over them until they are.
+	for (size_t row = SortedRows; row < FunctionRows.size(); row++)
+	{
+		MarkFunctionChanged(FunctionRows[row]);
+	}
+
+	if (RowPositions.size() < FunctionMap.size())
+	{
+		RowPositions.resize(FunctionMap.size(), ImClasses::IndexMap::InvalidSlot);
+	}
+
+	if (bFullSort || ((ChangedSlots.size() * 2) > FunctionRows.size()))
+	{
+		std::sort(FunctionRows.begin(), FunctionRows.end(), less);
+		for (size_t row = 0; row < FunctionRows.size(); row++) { RowPositions[FunctionRows[row]] = static_cast<uint32_t>(row); }
+	}
+	else
+	{
+		for (size_t row = SortedRows; row < FunctionRows.size(); row++) { RowPositions[FunctionRows[row]] = static_cast<uint32_t>(row); }
+
+		// Each flagged row is rotated from where it was straight to where it belongs, only the rows in between shift by one.
+		for (uint32_t slot : ChangedSlots)
+		{
+			size_t from = RowPositions[slot];
+
+			// Filtered out, or left over from before the rows were rebuilt.
+			if ((from >= FunctionRows.size()) || (FunctionRows[from] != slot))
+			{
+				ChangedFlags[slot] = 0;
+				continue;
+			}
 
-					if (copy_to_clipboard && ClipboardText.length() > 0)
-					{
-						ImGui::SetClipboardText(ClipboardText.c_str());
-						ClipboardText.clear();
-					}
+			size_t to = FindSortedPosition(sortSpecs, nowSecond, slot);
 
-					ImGui::EndTable();
-				}
+			if (to > from)
+			{
+				to--;
+				std::rotate((FunctionRows.begin() + from), (FunctionRows.begin() + from + 1), (FunctionRows.begin() + to + 1));
 			}
 			else
 			{
-				if (ImGui::BeginTable("###FunctionScanner_Default_Table", 3, TableFlags))
-				{
-					bool copy_to_clipboard = false;
-
-					if (ImGui::BeginPopupContextWindow())
-					{
-						copy_to_clipboard = ImGui::Selectable("Copy to Clipboard");
-						ImGui::EndPopup();
-					}
+				std::rotate((FunctionRows.begin() + to), (FunctionRows.begin() + from), (FunctionRows.begin() + from + 1));
+			}
 
-					ImGui::TableSetupColumn("Package Object", ImGuiTableColumnFlags_WidthFixed, 100.0f);
-					ImGui::TableSetupColumn("Calling Class", ImGuiTableColumnFlags_WidthStretch);
-					ImGui::TableSetupColumn("Function Name", ImGuiTableColumnFlags_WidthStretch);
-					ImGui::TableHeadersRow();
+			for (size_t row = std::min(from, to); row <= std::max(from, to); row++) { RowPositions[FunctionRows[row]] = static_cast<uint32_t>(row); }
+			ChangedFlags[slot] = 0; // In place now, later searches can compare against it.
+		}
+	}
 
-					for (size_t i = 0; i < FunctionHistory.size(); i++)
-					{
-						const ImClasses::FunctionData& data = FunctionHistory[i];
+	for (uint32_t slot : ChangedSlots) { ChangedFlags[slot] = 0; }
+	ChangedSlots.clear();
+	SortedRows = FunctionRows.size();
+	SortedSecond = nowSecond;
+}
 
-						if (PassesFilter(data.FullName))
-						{
-							ImGui::TableNextRow();
-							ImGui::TableSetColumnIndex(0);
-							ImGui::TextUnformatted(data.Package.c_str());
-							ImGui::TableSetColumnIndex(1);
-							ImGui::TextUnformatted(data.Caller.c_str());
-							ImGui::TableSetColumnIndex(2);
-							ImGui::TextUnformatted(data.Function.c_str());
+size_t ImFunctionScanner::FindSortedPosition(const ImGuiTableSortSpecs* sortSpecs, uint64_t nowSecond, uint32_t slot) const
+{
+	// Upper bound over the rows that are in order, flagged rows haven't been placed yet so a probe that lands on one steps past it.
+	size_t low = 0;
+	size_t high = FunctionRows.size();
 
-							if (copy_to_clipboard)
-							{
-								ClipboardText += data.FullName;
-								ClipboardText += "\n";
-							}
-						}
-					}
+	while (low < high)
+	{
+		size_t middle = (low + ((high - low) / 2));
+		size_t probe = middle;
 
-					if (copy_to_clipboard && ClipboardText.length() > 0)
-					{
-						ImGui::SetClipboardText(ClipboardText.c_str());
-						ClipboardText.clear();
-					}
+		while ((probe < high) && ChangedFlags[FunctionRows[probe]])
+		{
+			probe++;
+		}
 
-					ImGui::EndTable();
-				}
-			}
+		if ((probe == high) || FunctionRowLess(sortSpecs, nowSecond, slot, FunctionRows[probe]))
+		{
+			high = middle;
 		}
 		else
 		{
-			SetShouldRender(false);
-			ScanFunctions = false;
+			low = (probe + 1);
 		}
-
-		ImGui::End();
-	}
-	else
-	{
-		ScanFunctions = false;
 	}
+
+	return low;
 }
 
-bool ImFunctionScanner::IsScanning()
+uint64_t ImFunctionScanner::GetCurrentSecond()
 {
-	return ScanFunctions;
+	return (ImClasses::EventClock::ToNanoseconds(ImClasses::EventClock::Now()) / 1000000000);
 }
 
-void ImFunctionScanner::SaveToFile()
+void ImFunctionScanner::UpdateBaselineDiff(const ImGuiTableSortSpecs* sortSpecs)
 {
-	if (!FunctionHistory.empty())
+	const ImClasses::CaptureFunction* functions = Baseline.GetFunctions();
+	size_t baselineCount = Baseline.GetFunctionCount();
+
+	// Probe side, each live function is looked up once and the match is kept, so a refresh is just arithmetic over both sides.
+	for (size_t slot = BaselineMatches.size(); slot < FunctionMap.size(); slot++)
+	{
+		std::unordered_map<std::string_view, uint32_t>::const_iterator rowIt = BaselineRows.find(FunctionMap[slot].GetFullName());
+		BaselineMatches.push_back((rowIt != BaselineRows.end()) ? rowIt->second : ImClasses::IndexMap::InvalidSlot);
+	}
+
+	// Version 1 captures don't know how long they ran, their totals are compared as if both sessions were the same length.
+	double currentSeconds = std::max((GetSessionDuration() / 1000000000.0), 1.0);
+	double baselineSeconds = ((Baseline.GetDuration() != 0) ? std::max((Baseline.GetDuration() / 1000000000.0), 1.0) : currentSeconds);
+	std::vector<uint8_t> matched(baselineCount, 0);
+	DiffRows.clear();
+
+	for (uint32_t slot = 0; slot < static_cast<uint32_t>(FunctionMap.size()); slot++)
 	{
-		std::ofstream functionTable("FunctionDump_" + std::to_string(std::time(nullptr)) + ".txt");
+		// Hidden functions are left out on both sides, their baseline row has the same name so it's filtered below as well.
+		if (!PassesFilter(FunctionMap[slot]))
+		{
+			if (BaselineMatches[slot] != ImClasses::IndexMap::InvalidSlot) { matched[BaselineMatches[slot]] = 1; }
+			continue;
+		}
+
+		ImClasses::FunctionDiff diff = { BaselineMatches[slot], slot, 0.0f, static_cast<float>(FunctionMap[slot].Calls / currentSeconds), 0.0f, DiffStatuses::Appeared };
 
-		if (HideDuplicates)
+		if (diff.BaselineRow != ImClasses::IndexMap::InvalidSlot)
 		{
-			for (const auto& functionData : FunctionMap)
-			{
-				functionTable << functionData.second.FullName << std::endl;
-			}
+			matched[diff.BaselineRow] = 1;
+			diff.BaselineRate = static_cast<float>(functions[diff.BaselineRow].Calls / baselineSeconds);
+			diff.Change = ((diff.BaselineRate > 0.0f) ? (((diff.CurrentRate - diff.BaselineRate) / diff.BaselineRate) * 100.0f) : 0.0f);
+			diff.Status = ((std::fabs(diff.Change) > DiffThreshold) ? DiffStatuses::Changed : DiffStatuses::Unchanged);
 		}
 		else
 		{
-			for (const auto& functionData : FunctionHistory)
+			diff.Change = FLT_MAX;
+		}
+
+		if (!DiffChangesOnly || (diff.Status != DiffStatuses::Unchanged))
+		{
+			DiffRows.push_back(diff);
+		}
+	}
+
+	for (uint32_t row = 0; row < static_cast<uint32_t>(baselineCount); row++)
+	{
+		if (!matched[row] && PassesFilter(Baseline.GetFullName(functions[row].FullName)))
+		{
+			DiffRows.push_back(ImClasses::FunctionDiff{ row, ImClasses::IndexMap::InvalidSlot, static_cast<float>(functions[row].Calls / baselineSeconds), 0.0f, -100.0f, DiffStatuses::Vanished });
+		}
+	}
+
+	auto getName = [&](const ImClasses::FunctionDiff& diff) -> std::string_view {
+		return ((diff.Slot != ImClasses::IndexMap::InvalidSlot) ? std::string_view(FunctionMap[diff.Slot].GetFullName()) : Baseline.GetFullName(functions[diff.BaselineRow].FullName));
+	};
+
+	auto getCalls = [&](uint32_t row, bool bBaseline) -> uint64_t {
+		return (bBaseline ? ((row != ImClasses::IndexMap::InvalidSlot) ? functions[row].Calls : 0) : ((row != ImClasses::IndexMap::InvalidSlot) ? FunctionMap[row].Calls : 0));
+	};
+
+	if (sortSpecs && (sortSpecs->SpecsCount > 0))
+	{
+		auto compare = [](auto leftValue, auto rightValue) -> int32_t { return ((leftValue < rightValue) ? -1 : (leftValue > rightValue)); };
+
+		std::sort(DiffRows.begin(), DiffRows.end(), [&](const ImClasses::FunctionDiff& left, const ImClasses::FunctionDiff& right) {
+			for (int32_t i = 0; i < sortSpecs->SpecsCount; i++)
 			{
-				functionTable << functionData.FullName << std::endl;
+				const ImGuiTableColumnSortSpecs& spec = sortSpecs->Specs[i];
+				int32_t delta = 0;
+
+				switch (static_cast<DiffColumns>(spec.ColumnUserID))
+				{
+				case DiffColumns::Status: delta = compare(left.Status, right.Status); break;
+				case DiffColumns::Function: delta = getName(left).compare(getName(right)); break;
+				case DiffColumns::BaselineCalls: delta = compare(getCalls(left.BaselineRow, true), getCalls(right.BaselineRow, true)); break;
+				case DiffColumns::CurrentCalls: delta = compare(getCalls(left.Slot, false), getCalls(right.Slot, false)); break;
+				case DiffColumns::BaselineRate: delta = compare(left.BaselineRate, right.BaselineRate); break;
+				case DiffColumns::CurrentRate: delta = compare(left.CurrentRate, right.CurrentRate); break;
+				case DiffColumns::Change: delta = compare(left.Change, right.Change); break;
+				default: break;
+				}
+
+				if (delta != 0)
+				{
+					return ((spec.SortDirection == ImGuiSortDirection_Ascending) ? (delta < 0) : (delta > 0));
+				}
 			}
-		}
 
-		functionTable.close();
+			return ((left.Slot != right.Slot) ? (left.Slot < right.Slot) : (left.BaselineRow < right.BaselineRow));
+		});
 	}
-}
 
-void ImFunctionScanner::ClearTable()
-{
-	FunctionMap.clear();
-	FunctionHistory.clear();
+	DiffSecond = GetCurrentSecond();
+	DiffDirty = false;
 }
 
-bool ImFunctionScanner::PassesFilter(const std::string& textToFilter)
+void ImFunctionScanner::RenderBaselineDiff()
 {
-	const char* filterText = textToFilter.c_str();
-
-	if (Whitelist.IsActive())
+	if (ImGui::BeginTable("###FunctionScanner_Diff_Table", static_cast<int32_t>(DiffColumns::END), (TableFlags | ImGuiTableFlags_Sortable)))
 	{
-		if (Whitelist.PassFilter(filterText))
+		ImGui::TableSetupScrollFreeze(0, 1);
+		ImGui::TableSetupColumn("Status", ImGuiTableColumnFlags_WidthFixed, 70.0f, static_cast<ImGuiID>(DiffColumns::Status));
+		ImGui::TableSetupColumn("Function", ImGuiTableColumnFlags_WidthStretch, 0.0f, static_cast<ImGuiID>(DiffColumns::Function));
+		ImGui::TableSetupColumn("Baseline Calls", (ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_PreferSortDescending), 80.0f, static_cast<ImGuiID>(DiffColumns::BaselineCalls));
+		ImGui::TableSetupColumn("Calls", (ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_PreferSortDescending), 80.0f, static_cast<ImGuiID>(DiffColumns::CurrentCalls));
+		ImGui::TableSetupColumn("Baseline /s", (ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_PreferSortDescending), 70.0f, static_cast<ImGuiID>(DiffColumns::BaselineRate));
+		ImGui::TableSetupColumn("/s", (ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_PreferSortDescending), 70.0f, static_cast<ImGuiID>(DiffColumns::CurrentRate));
+		ImGui::TableSetupColumn("Change", (ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_PreferSortDescending | ImGuiTableColumnFlags_DefaultSort), 70.0f, static_cast<ImGuiID>(DiffColumns::Change));
+		ImGui::TableHeadersRow();
+
+		if (ImGuiTableSortSpecs* sortSpecs = ImGui::TableGetSortSpecs())
 		{
-			if (Blacklist.IsActive())
+			if (sortSpecs->SpecsDirty || DiffDirty || (IsScanning() && (DiffSecond != GetCurrentSecond())))
 			{
-				return (!Blacklist.PassFilter(filterText));
+				UpdateBaselineDiff(sortSpecs);
+				sortSpecs->SpecsDirty = false;
 			}
-
-			return true;
 		}
 
-		return false;
-	}
+		static const char* statusNames[] = { "Same", "Changed", "New", "Gone" };
+		static const TextColors statusColors[] = { TextColors::Grey, TextColors::Orange, TextColors::Green, TextColors::Red };
+		const ImClasses::CaptureFunction* functions = Baseline.GetFunctions();
+		ImGuiListClipper clipper;
+		clipper.Begin(static_cast<int32_t>(DiffRows.size()));
 
-	if (Blacklist.IsActive())
-	{
-		if (!Blacklist.PassFilter(filterText))
+		while (clipper.Step())
 		{
-			if (Whitelist.IsActive())
+			for (int32_t row = clipper.DisplayStart; row < clipper.DisplayEnd; row++)
 			{
-				return (Whitelist.PassFilter(filterText));
+				const ImClasses::FunctionDiff& diff = DiffRows[row];
+				bool inBaseline = (diff.BaselineRow != ImClasses::IndexMap::InvalidSlot);
+				bool inSession = (diff.Slot != ImClasses::IndexMap::InvalidSlot);
+				std::string_view name = (inSession ? std::string_view(FunctionMap[diff.Slot].GetFullName()) : Baseline.GetFullName(functions[diff.BaselineRow].FullName));
+
+				ImGui::TableNextRow();
+				ImGui::TableSetColumnIndex(0);
+				ImGui::TextColored(ImColorMap[statusColors[static_cast<size_t>(diff.Status)]], "%s", statusNames[static_cast<size_t>(diff.Status)]);
+				ImGui::TableSetColumnIndex(1);
+				ImGui::TextUnformatted(name.data(), (name.data() + name.size()));
+				ImGui::TableSetColumnIndex(2);
+				if (inBaseline) { ImGui::Text("%llu", static_cast<unsigned long long>(functions[diff.BaselineRow].Calls)); } else { ImGui::TextDisabled("-"); }
+				ImGui::TableSetColumnIndex(3);
+				if (inSession) { ImGui::Text("%zu", FunctionMap[diff.Slot].Calls); } else { ImGui::TextDisabled("-"); }
+				ImGui::TableSetColumnIndex(4);
+				ImGui::Text("%.1f", diff.BaselineRate);
+				ImGui::TableSetColumnIndex(5);
+				ImGui::Text("%.1f", diff.CurrentRate);
+				ImGui::TableSetColumnIndex(6);
+				if (diff.Status == DiffStatuses::Appeared) { ImGui::TextDisabled("new"); } else { ImGui::Text("%+.1f%%", diff.Change); }
 			}
-
-			return true;
 		}
 
-		return false;
+		ImGui::EndTable();
 	}
-
-	return true;
 }
 
-ImNotification::ImNotification(const std::string& title, const std::string& name) : ImInterface(title, name, NULL, false) {}
+void ImFunctionScanner::RenderCallGraph(uint32_t node)
+{
+	// Closed nodes return early from "TreeNodeEx", so only the open part of the tree is ever walked or sorted.
+	FunctionGraph.SortChildren(node);
+	const ImClasses::CallGraph::Node& parent = FunctionGraph.GetNode(node);
+	double parentCalls = static_cast<double>(std::max<uint64_t>(parent.Calls, 1));
 
-ImNotification::~ImNotification() { OnDetatch(); }
+	for (size_t i = 0; i < parent.Children.size(); i++)
+	{
+		uint32_t child = parent.Children[i];
+		const ImClasses::CallGraph::Node& childNode = FunctionGraph.GetNode(child);
+		const std::string& name = ImClasses::FunctionData::ObjectNames.Get(childNode.Name);
+		bool leaf = childNode.Children.empty();
+		ImGuiTreeNodeFlags flags = (leaf ? (ImGuiTreeNodeFlags_Leaf | ImGuiTreeNodeFlags_NoTreePushOnOpen) : ImGuiTreeNodeFlags_None);
 
-void ImNotification::OnAttach()
-{
-	WindowPadding = 10.0f;
-	WindowOffset = 0.0f;
-	Corner = CornerPositions::TopLeft;
-	WindowFlags = (ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoNav | ImGuiWindowFlags_NoInputs);
-	DescriptionColor = ImColorMap[TextColors::White];
-	DeltaTime = 0.0f;
-	CutoffTime = 300.0f;
-	BaseAlpha = 0.85f;
-	LastAlpha = BaseAlpha;
-	FadeOut = false;
-	SetAttached(true);
+		bool open = ImGui::TreeNodeEx(reinterpret_cast<void*>(static_cast<uintptr_t>(child)), flags, "%s", name.c_str());
+		ImGui::SameLine();
+		ImGui::TextDisabled("%llu calls (%.1f%%)", static_cast<unsigned long long>(childNode.Calls), ((childNode.Calls * 100.0) / parentCalls));
+
+		if (open && !leaf)
+		{
+			RenderCallGraph(child);
+			ImGui::TreePop();
+		}
+	}
 }
 
-void ImNotification::OnDetatch()
+void ImFunctionScanner::RenderTimeline()
 {
-	if (IsAttached())
+	FrameCalls.Update();
+
+	ImDrawList* drawList = ImGui::GetWindowDrawList();
+	ImVec2 canvasMin = ImGui::GetCursorScreenPos();
+	ImVec2 canvasSize(std::max(ImGui::GetContentRegionAvail().x, 64.0f), 80.0f);
+	ImVec2 canvasMax((canvasMin.x + canvasSize.x), (canvasMin.y + canvasSize.y));
+	bool clicked = ImGui::InvisibleButton("###Scanner_Timeline_Canvas", canvasSize);
+	bool hovered = ImGui::IsItemHovered();
+	drawList->AddRectFilled(canvasMin, canvasMax, ImGui::GetColorU32(ImGuiCol_FrameBg));
+
+	if (FrameCalls.GetFrameCount() == 0)
 	{
-		SetAttached(false);
+		drawList->AddText(ImVec2((canvasMin.x + 4.0f), (canvasMin.y + 4.0f)), ImGui::GetColorU32(ImGuiCol_TextDisabled), "No calls recorded yet.");
+		return;
 	}
-}
 
-void ImNotification::OnRender()
-{
-	if (ShouldRender())
+	ImGuiIO& io = ImGui::GetIO();
+	double firstFrame = static_cast<double>(FrameCalls.GetFirstFrame());
+	double frameCount = static_cast<double>(FrameCalls.GetFrameCount());
+	double span = ((TimelineSpan > 0.0) ? std::min(TimelineSpan, frameCount) : frameCount);
+	double start = ((TimelineSpan > 0.0) ? TimelineStart : firstFrame);
+	double mouseOffset = ((io.MousePos.x - canvasMin.x) / canvasSize.x);
+
+	// Wheel zooms around the cursor, right drag pans. Zooming all the way out goes back to following the capture.
+	if (hovered && (io.MouseWheel != 0.0f))
 	{
-		if (!FadeOut && (DeltaTime > CutoffTime))
-		{
-			DeltaTime = 0.0f;
-			LastAlpha = BaseAlpha;
-			TitleColor.w = LastAlpha;
-			DescriptionColor.w = LastAlpha;
-			FadeOut = true;
-		}
-		else if (FadeOut && (LastAlpha < 0.0f))
+		double mouseFrame = (start + (mouseOffset * span));
+		span = std::min(std::max((span * std::pow(0.8, io.MouseWheel)), 8.0), frameCount);
+		start = (mouseFrame - (mouseOffset * span));
+	}
+
+	if (hovered && ImGui::IsMouseDragging(ImGuiMouseButton_Right, 0.0f))
+	{
+		start -= ((io.MouseDelta.x / canvasSize.x) * span);
+	}
+
+	start = std::clamp(start, firstFrame, (firstFrame + frameCount - span));
+	TimelineSpan = ((span < frameCount) ? span : 0.0);
+	TimelineStart = start;
+
+	// Lowest level with at least a pixel per entry, so no more than about one rectangle per pixel is ever drawn.
+	double framesPerPixel = (span / canvasSize.x);
+	size_t level = 0;
+
+	while (((level + 1) < FrameCalls.GetLevelCount()) && (static_cast<double>(1ULL << level) < framesPerPixel))
+	{
+		level++;
+	}
+
+	double entryFrames = static_cast<double>(1ULL << level);
+	double pixelsPerFrame = (canvasSize.x / span);
+	size_t levelSize = FrameCalls.GetLevelSize(level);
+	size_t firstEntry = std::min(static_cast<size_t>((start - firstFrame) / entryFrames), (levelSize - 1));
+	size_t endEntry = std::min(static_cast<size_t>(std::ceil((start + span - firstFrame) / entryFrames)), levelSize);
+	uint32_t peak = 1;
+
+	for (size_t entry = firstEntry; entry < endEntry; entry++)
+	{
+		peak = std::max(peak, FrameCalls.Get(level, entry).Max);
+	}
+
+	double mouseFrame = (start + (mouseOffset * span));
+	size_t hoveredEntry = ((hovered && (mouseFrame >= firstFrame)) ? static_cast<size_t>((mouseFrame - firstFrame) / entryFrames) : levelSize);
+	float scale = ((canvasSize.y - 14.0f) / peak);
+	ImU32 minColor = ImGui::GetColorU32(ImGuiCol_PlotHistogram);
+	ImU32 maxColor = ImGui::GetColorU32(ImGuiCol_PlotHistogram, 0.45f);
+	ImU32 hoveredColor = ImGui::GetColorU32(ImGuiCol_PlotHistogramHovered);
+	drawList->PushClipRect(canvasMin, canvasMax, true);
+
+	if (FrameFilterEnd != 0)
+	{
+		float x0 = static_cast<float>(canvasMin.x + ((FrameFilterBegin - start) * pixelsPerFrame));
+		float x1 = static_cast<float>(canvasMin.x + ((FrameFilterEnd - start) * pixelsPerFrame));
+		drawList->AddRectFilled(ImVec2(x0, canvasMin.y), ImVec2(std::max(x1, (x0 + 1.0f)), canvasMax.y), ImGui::GetColorU32(ImGuiCol_TextSelectedBg));
+	}
+
+	// Bars span the busiest frame in each entry, the solid part the quietest one.
+	for (size_t entry = firstEntry; entry < endEntry; entry++)
+	{
+		ImClasses::FrameTimeline::Range range = FrameCalls.Get(level, entry);
+		float x0 = static_cast<float>(canvasMin.x + ((firstFrame + (entry * entryFrames) - start) * pixelsPerFrame));
+		float x1 = std::max(static_cast<float>(x0 + (entryFrames * pixelsPerFrame)), (x0 + 1.0f));
+		bool entryHovered = (entry == hoveredEntry);
+		drawList->AddRectFilled(ImVec2(x0, (canvasMax.y - (range.Max * scale))), ImVec2(x1, canvasMax.y), (entryHovered ? hoveredColor : maxColor));
+
+		if (range.Min > 0)
 		{
-			DeltaTime = 0.0f;
-			LastAlpha = BaseAlpha;
-			TitleColor.w = LastAlpha;
-			DescriptionColor.w = LastAlpha;
-			FadeOut = false;
-			SetShouldRender(false);
-			return;
+			drawList->AddRectFilled(ImVec2(x0, (canvasMax.y - (range.Min * scale))), ImVec2(x1, canvasMax.y), (entryHovered ? hoveredColor : minColor));
 		}
+	}
 
-		ImGuiViewport* viewport = ImGui::GetMainViewport();
-		ImVec2 work_pos = viewport->WorkPos;
-		ImVec2 work_size = viewport->WorkSize;
-		ImVec2 window_pos;
-		ImVec2 window_pos_pivot;
-
-		window_pos.x = (Corner == CornerPositions::TopRight || Corner == CornerPositions::BottomRight) ? (work_pos.x + work_size.x - WindowPadding) : (work_pos.x + WindowPadding);
-		window_pos.y = (Corner == CornerPositions::BottomRight || Corner == CornerPositions::BottomLeft) ? (work_pos.y + work_size.y - WindowPadding) : (work_pos.y + WindowPadding);
-		window_pos_pivot.x = (Corner == CornerPositions::TopRight || Corner == CornerPositions::BottomRight) ? 1.0f : 0.0f;
-		window_pos_pivot.y = (Corner == CornerPositions::BottomRight || Corner == CornerPositions::BottomLeft) ? 1.0f : 0.0f;
-		
-		if (Corner == CornerPositions::TopLeft) { window_pos.y += WindowOffset; }
-		else if (Corner == CornerPositions::TopRight) { window_pos.y += WindowOffset; }
-		else if (Corner == CornerPositions::BottomLeft) { window_pos.y -= WindowOffset; }
-		else if (Corner == CornerPositions::BottomRight) { window_pos.y -= WindowOffset; }
+	std::string peakText = (std::to_string(peak) + " calls/frame");
+	drawList->AddText(ImVec2((canvasMin.x + 4.0f), (canvasMin.y + 1.0f)), ImGui::GetColorU32(ImGuiCol_TextDisabled), peakText.c_str());
+	drawList->PopClipRect();
 
-		ImGui::SetNextWindowPos(window_pos, ImGuiCond_Always, window_pos_pivot);
-		ImGui::SetNextWindowSize(ImVec2(325.0f, 75.0f), ImGuiCond_Always);
+	if (hoveredEntry < levelSize)
+	{
+		ImClasses::FrameTimeline::Range range = FrameCalls.Get(level, hoveredEntry);
+		uint32_t entryFirstFrame = static_cast<uint32_t>(firstFrame + (hoveredEntry * entryFrames));
+		uint32_t entryEndFrame = static_cast<uint32_t>(std::min((firstFrame + ((hoveredEntry + 1) * entryFrames)), (firstFrame + frameCount)));
 
-		if (FadeOut)
+		if (level == 0)
 		{
-			LastAlpha -= (GetRenderTime() / 100.0f);
-			ImGui::SetNextWindowBgAlpha(LastAlpha);
+			ImGui::SetTooltip("Frame %u\n%u calls\nClick to show only this frame.", entryFirstFrame, range.Max);
 		}
 		else
 		{
-			ImGui::SetNextWindowBgAlpha(BaseAlpha);
+			ImGui::SetTooltip("Frames %u - %u\n%u - %u calls per frame\nClick to show only these frames.", entryFirstFrame, (entryEndFrame - 1), range.Min, range.Max);
 		}
 
-		if (ImGui::Begin(GetTitle().c_str(), ShouldBegin(), WindowFlags))
+		if (clicked)
 		{
-			SetIsFocused(ImGui::IsWindowFocused());
-
-			if (ImGui::BeginChild(std::string("###" + GetName() + "_Notification_ScrollRegion").c_str()))
-			{
-				TitleColor.w = LastAlpha;
-				DescriptionColor.w = LastAlpha;
-
-				ImExtensions::TextStyled(Title.c_str(), TitleColor, ImFontMap[TextStyles::Bold]);
-				ImGui::PushTextWrapPos(ImGui::GetWindowWidth() - 1.0f);
-				ImExtensions::TextStyled(Description.c_str(), DescriptionColor, ImFontMap[TextStyles::Regular]);
-				ImGui::PopTextWrapPos();
-			}
-
-			DeltaTime += GetRenderTime();
+			SetFrameFilter(entryFirstFrame, entryEndFrame);
 		}
-
-		ImGui::End();
 	}
 }
 
-float ImNotification::GetRenderTime() const
-{
-	float framerate = ImGui::GetIO().Framerate;
-	if (framerate <= 15) { framerate = 4.0f; }
-	if (framerate <= 30) { framerate = 2.0f; }
-	else if (framerate <= 60) { framerate = 1.0f; }
-	else if (framerate <= 120) { framerate = 0.5f; }
-	else if (framerate <= 144) { framerate = 0.4167f; }
-	else if (framerate <= 240) { framerate = 0.25f; }
-	else if (framerate <= 360) { framerate = 0.1667f; }
-	else if (framerate <= 480) { framerate = 0.125f; }
-	else if (framerate > 480) { framerate = 0.1f; }
-	return framerate;
-}
-
-ImNotification* ImNotification::SetInformation(const std::string& title, const std::string& description, TextColors color, CornerPositions corner)
-{
-	SetTitle(title);
-	SetDescription(description);
-	SetColor(color);
-	SetPosition(corner);
-	return this;
-}
-
-ImNotification* ImNotification::SetTitle(const std::string& title)
+void ImFunctionScanner::SetFrameFilter(uint32_t firstFrame, uint32_t endFrame)
 {
-	Title = title;
-	return this;
-}
+	FrameFilterBegin = ((endFrame > firstFrame) ? firstFrame : 0);
+	FrameFilterEnd = ((endFrame > firstFrame) ? endFrame : 0);
 
-ImNotification* ImNotification::SetDescription(const std::string& description)
-{
-	Description = description;
-	return this;
-}
+	// Only the history table has per-event frames, the aggregated views can't be narrowed down to a range.
+	if (FrameFilterEnd != 0)
+	{
+		HideDuplicates = false;
+		ShowCallGraph = false;
+	}
 
-ImNotification* ImNotification::SetColor(TextColors color)
-{
-	TitleColor = ImColorMap[color];
-	TitleColor.w = LastAlpha;
-	return this;
+	HistoryRows.clear();
+	HistoryScanned = 0;
 }
 
-ImNotification* ImNotification::SetPosition(CornerPositions corner)
+bool ImFunctionScanner::PassesFrameFilter(const ImClasses::FunctionData& functionData) const
 {
-	Corner = corner;
-	return this;
+	return ((FrameFilterEnd == 0) || ((functionData.Frame >= FrameFilterBegin) && (functionData.Frame < FrameFilterEnd)));
 }
 
-ImNotification* ImNotification::SetOffset(float offset)
+void ImFunctionScanner::SetFilters(const std::string& whitelist, const std::string& blacklist)
 {
-	WindowOffset = offset;
-	return this;
+	strcpy_s(Whitelist.InputBuf, sizeof(Whitelist.InputBuf), whitelist.substr(0, (sizeof(Whitelist.InputBuf) - 1)).c_str());
+	strcpy_s(Blacklist.InputBuf, sizeof(Blacklist.InputBuf), blacklist.substr(0, (sizeof(Blacklist.InputBuf) - 1)).c_str());
+	Whitelist.Build();
+	Blacklist.Build();
+	OnFilterChanged();
 }
 
-ImNotificationManager::ImNotificationManager(const std::string& title, const std::string& name, std::function<void(std::string, bool)> toggleCallback) : ImInterface(title, name, toggleCallback, false) {}
-
-ImNotificationManager::~ImNotificationManager() { OnDetatch(); }
-
-void ImNotificationManager::OnAttach()
+size_t ImFunctionScanner::GetMemoryUsage() const
 {
-	// Create notifications here for them to be properly managed, rendering for them is called in the managers "OnRender" function.
-	CreateNotification(new ImNotification("Example Notification", "example_notification"))->SetInformation("This is an example", "This is an example description!", TextColors::Green);
-	SetAttached(true);
+	size_t bytes = (FunctionHistory.GetBytes() + ImClasses::FunctionData::FullNames.GetBytes() + ImClasses::FunctionData::ObjectNames.GetBytes());
+	bytes += (FunctionSlots.GetBytes() + VerdictSlots.GetBytes() + (FilterVerdicts.capacity() * sizeof(uint32_t)) + CaptureVerdicts.GetBytes());
+	bytes += ((FunctionMap.capacity() * sizeof(ImClasses::FunctionCount)) + (FunctionTimings.capacity() * sizeof(ImClasses::FunctionTiming)) + (FunctionRates.capacity() * sizeof(ImClasses::FunctionRate)));
+	bytes += ((HistoryRows.size() * sizeof(uint64_t)) + (FunctionRows.capacity() * sizeof(uint32_t)) + FrameCalls.GetBytes());
+	return bytes;
 }
 
-void ImNotificationManager::OnDetatch()
+void ImFunctionScanner::DrainEvents()
 {
-	if (IsAttached())
-	{
-		ActiveNotifications.clear();
+	bool recording = (RecordToDisk && IsScanning());
 
-		for (auto& notification : CreatedNotifications)
+	if (recording && !DiskRecorder.IsActive()) { StartRecording(); }
+
+	// Bounded by the ring's capacity so a producer flood can only ever cost us one ring's worth of work per frame.
+	EventQueue.Drain([this, recording](const ImClasses::FunctionEvent& functionEvent) {
+		if (CaptureVerdicts.Get(functionEvent.FunctionIndex) == FilterStates::Rejected)
 		{
-			if (notification.second)
-			{
-				notification.second->OnDetatch();
-			}
+			return; // Queued before the verdict was published.
 		}
 
-		CreatedNotifications.clear();
-		SetAttached(false);
-	}
+		ImClasses::FunctionData newEntry(functionEvent);
+		newEntry.Timestamp = ImClasses::EventClock::ToNanoseconds(functionEvent.Timestamp);
+
+		if (PassesFilter(newEntry))
+		{
+			AddEvent(newEntry, functionEvent.Duration, functionEvent.Weight, recording);
+		}
+	}, EventQueue.GetCapacity());
+
+	size_t dropped = EventQueue.GetDropped();
+	DroppedLastFrame = (dropped - DroppedSnapshot);
+	DroppedSnapshot = dropped;
+
+	if (!recording && DiskRecorder.IsActive()) { StopRecording(); }
 }
 
-void ImNotificationManager::OnRender()
+void ImFunctionScanner::AddEvent(const ImClasses::FunctionData& newEntry, uint64_t duration, uint32_t weight, bool bRecording)
 {
-	if (!ActiveNotifications.empty())
+	AddToHistory(newEntry);
+
+	if (bRecording)
 	{
-		for (auto notificationIt = ActiveNotifications.begin(); notificationIt != ActiveNotifications.end();)
-		{
-			if (*notificationIt && !(*notificationIt)->ShouldRender())
-			{
-				notificationIt = ActiveNotifications.erase(notificationIt);
-			}
-			else
-			{
-				notificationIt++;
-			}
-		}
+		DiskRecorder.Append(newEntry);
 	}
 
-	for (const auto& notification : CreatedNotifications)
+	bool inserted = false;
+	uint32_t slot = FunctionSlots.FindOrInsert(newEntry.Index, static_cast<uint32_t>(FunctionMap.size()), inserted);
+
+	if (inserted)
 	{
-		if (notification.second && notification.second->ShouldRender())
-		{
-			bool alreadyActive = false;
+		FunctionMap.push_back(ImClasses::FunctionCount(newEntry));
+		FunctionRates.emplace_back();
+		DiffDirty = true;
+	}
 
-			for (const auto& activeNotification : ActiveNotifications)
-			{
-				if (activeNotification == notification.second)
-				{
-					alreadyActive = true;
-					break;
-				}
-			}
+	FunctionMap[slot].Calls += weight;
+	FunctionGraph.Add(newEntry.Package, newEntry.Caller, newEntry.Function, weight);
+	FrameCalls.Add(newEntry.Frame, weight);
+	FunctionRates[slot].Add((newEntry.Timestamp / 1000000000), weight);
+	MarkFunctionChanged(slot);
 
-			if (!alreadyActive)
-			{
-				ActiveNotifications.push_back(notification.second);
-			}
+	if (duration != 0)
+	{
+		if (FunctionTimings.size() <= slot)
+		{
+			FunctionTimings.resize(FunctionMap.size());
 		}
+
+		FunctionTimings[slot].Add(ImClasses::EventClock::ToNanoseconds(duration), weight);
 	}
+}
 
-	if (!ActiveNotifications.empty())
+void ImFunctionScanner::AddToHistory(const ImClasses::FunctionData& functionData)
+{
+	if (CapturePolicy != CapturePolicies::Reservoir)
 	{
-		for (size_t i = 0; i < ActiveNotifications.size(); i++)
-		{
-			std::shared_ptr<ImNotification> notification = ActiveNotifications[i];
+		FunctionHistory.Push(functionData);
+		return;
+	}
 
-			if (notification)
-			{
-				float offset = 0.0f;
+	// Algorithm R, every event seen so far has the same chance of being in the history no matter how long monitoring runs.
+	// Capped by what the memory cap holds too, evicting the oldest block instead would throw away part of the sample.
+	ReservoirSeen++;
+	size_t capacity = GetReservoirCapacity(FunctionHistory.GetMemoryCap());
 
-				if (i != 0)
-				{
-					offset = (i * 85.0f); // 85 being the notification's window height (75) plus padding (10).
-				}
+	if (FunctionHistory.Size() < capacity)
+	{
+		FunctionHistory.Push(functionData);
+	}
+	else
+	{
+		uint64_t position = std::uniform_int_distribution<uint64_t>(0, (ReservoirSeen - 1))(ReservoirRandom);
 
-				notification->SetOffset(offset);
-				notification->OnRender();
-			}
+		if (position < FunctionHistory.Size())
+		{
+			uint64_t id = (FunctionHistory.GetFirstId() + position);
+			FunctionHistory.Set(id, functionData);
+			PatchHistoryRow(id);
 		}
 	}
 }
 
-void ImNotificationManager::ToggleNotification(const std::string& windowName)
+size_t ImFunctionScanner::GetReservoirCapacity(size_t memoryCap) const
 {
-	std::shared_ptr<ImNotification> notification = GetNotification(windowName);
+	return std::min(static_cast<size_t>(ReservoirSize), ImClasses::HistoryStore::GetRecordCapacity(memoryCap));
+}
 
-	if (notification)
+void ImFunctionScanner::TrimReservoir(size_t capacity)
+{
+	size_t size = FunctionHistory.Size();
+
+	if (size <= capacity)
 	{
-		notification->ToggleRender();
+		return;
 	}
-}
 
-std::shared_ptr<ImNotification> ImNotificationManager::GetNotification(const std::string& windowName)
-{
-	if (CreatedNotifications.find(windowName) != CreatedNotifications.end())
+	// Selection sampling, each event is kept with chance "needed / remaining" which picks every subset of "capacity" events equally often.
+	uint64_t firstId = FunctionHistory.GetFirstId();
+	size_t kept = 0;
+
+	for (size_t position = 0; (position < size) && (kept < capacity); position++)
 	{
-		return CreatedNotifications[windowName];
+		if (std::uniform_int_distribution<size_t>(0, (size - position - 1))(ReservoirRandom) < (capacity - kept))
+		{
+			if (kept != position)
+			{
+				FunctionHistory.Set((firstId + kept), FunctionHistory[firstId + position]);
+			}
+
+			kept++;
+		}
 	}
 
-	return nullptr;
+	FunctionHistory.Truncate(capacity);
+
+	// Every surviving event may have moved, only the history rows need to be rebuilt.
+	HistoryRows.clear();
+	HistoryScanned = 0;
 }
 
-std::shared_ptr<ImNotification> ImNotificationManager::CreateNotification(ImNotification* notification)
+uint32_t ImFunctionScanner::SampleEvent(class UFunction* function, uint64_t nowTicks)
 {
-	if (notification)
+	switch (CapturePolicy.load(std::memory_order_relaxed))
 	{
-		std::string notificationName = notification->GetName();
+	case CapturePolicies::OneInN:
+	{
+		static thread_local uint32_t eventCounter = 0;
+		uint32_t interval = SampleInterval.load(std::memory_order_relaxed);
+		return (((++eventCounter % interval) == 0) ? interval : 0);
+	}
+	case CapturePolicies::TokenBucket:
+	{
+		uint32_t weight = 0;
+		uint32_t rate = TokenRate.load(std::memory_order_relaxed);
+		uint64_t hash = ((reinterpret_cast<uintptr_t>(function) >> 4) * 0x9E3779B97F4A7C15ULL);
 
-		if (CreatedNotifications.find(notificationName) == CreatedNotifications.end())
+		for (size_t probe = 0; probe < TokenBucketProbes; probe++)
 		{
-			CreatedNotifications.emplace(notificationName, std::shared_ptr<ImNotification>(notification)).first->second->OnAttach();
-			return CreatedNotifications[notificationName];
+			ImClasses::TokenBucket& bucket = TokenBuckets[((hash >> 32) + probe) & (TokenBucketCount - 1)];
+
+			if (bucket.Claim(function))
+			{
+				return (bucket.TryConsume(nowTicks, (ImClasses::EventClock::GetTicksPerSecond() / rate), static_cast<double>(rate), weight) ? weight : 0);
+			}
 		}
+
+		return 1; // Every bucket it could use belongs to another function, capturing it unthrottled beats spending someone else's budget.
 	}
+	default:
+		return 1;
+	}
+}
 
-	return nullptr;
+int32_t ImFunctionScanner::GetFunctionIndex(class UFunction* function)
+{
+	// Requires an actual SDK for your game, same as the "FunctionData" constructor. Without it nothing is ever pre-filtered and every event goes through the regular filters.
+	//return (function ? function->ObjectInternalInteger : -1);
+	return -1;
+}
+
+int32_t ImFunctionScanner::GetObjectIndex(class UObject* object)
+{
+	// Requires an actual SDK for your game.
+	//return (object ? object->ObjectInternalInteger : -1);
+	return -1;
+}
+
+uint32_t ImFunctionScanner::GetObjectGeneration(class UObject* object)
+{
+	// Requires an actual SDK for your game, the serial number of the object's slot in the global object array.
+	//return (object ? GUObjectArray.ObjectToObjectItem(object)->SerialNumber : 0);
+	return 0;
+}
+
+uint64_t ImFunctionScanner::OnProcessEventBegin()
+{
+	return ((IsScanning() && TimeFunctions) ? ImClasses::EventClock::Now() : 0);
 }
 
-void ImFunctionScanner::OnProcessEvent(class UObject* caller, class UFunction* function)
+void ImFunctionScanner::OnProcessEvent(class UObject* caller, class UFunction* function, uint64_t beginTicks)
 {
-	if (ShouldRender() && IsScanning() && caller && function)
+	// Only a slot write happens here, name resolution and the tables are handled by the render thread in "DrainEvents".
+	if (IsScanning() && caller && function)
 	{
-		// Requires and actual SDK for your game, so that's why this is commented out.
-		// 
-		//std::string fullName = function->GetFullName();
+		// Functions the filters already rejected leave after a single bit test, before sampling or touching the ring.
+		int32_t functionIndex = GetFunctionIndex(function);
 
-		//if (PassesFilter(fullName.c_str()))
-		//{
-		//	ImClasses::FunctionData newEntry(caller, function);
-		//	FunctionHistory.push_back(newEntry);
+		if (CaptureVerdicts.Get(functionIndex) == FilterStates::Rejected)
+		{
+			return;
+		}
 
-		//	for (auto& data : FunctionMap)
-		//	{
-		//		if (data.first == newEntry.Index)
-		//		{
-		//			data.second.Calls++;
-		//			return;
-		//		}
-		//	}
+		uint64_t now = ImClasses::EventClock::Now();
+		uint32_t weight = SampleEvent(function, now);
 
-		//	FunctionMap.push_back(std::make_pair(newEntry.Index, newEntry));
-		//}
+		if (weight > 0)
+		{
+			EventQueue.Push(ImClasses::FunctionEvent(caller, function, functionIndex, GetObjectIndex(caller), GetObjectGeneration(caller), FrameCounter.load(std::memory_order_relaxed), now, ((beginTicks != 0) ? (now - beginTicks) : 0), weight));
+		}
 	}
 }
 
@@ -805,10 +4927,18 @@ void ImTerminal::OnAttach()
 {
 	MaxUserHistory = 64;
 	MaxConsoleHistory = 256;
+	ConsoleText.SetCapacity(MaxConsoleHistory);
 	HistoryPos = -1;
 	InputFlags = (ImGuiInputTextFlags_EnterReturnsTrue | ImGuiInputTextFlags_CallbackCompletion | ImGuiInputTextFlags_CallbackHistory | ImGuiInputTextFlags_CallbackEdit);
 	CandidatePos = 0;
+	CandidateTotal = 0;
+	FuzzyComplete = false;
 	ArgumentType = ImArgumentIds::IM_None;
+	InvalidateLines();
+	LayoutWidth = 0.0f;
+	LayoutIndent = 0.0f;
+	LayoutFontSize = 0.0f;
+	LayoutFont = nullptr;
 	AutoScroll = true;
 	ScrollToBottom = false;
 	memset(InputBuffer, 0, IM_ARRAYSIZE(InputBuffer));
@@ -826,6 +4956,8 @@ void ImTerminal::OnDetatch()
 
 void ImTerminal::OnRender()
 {
+	DrainQueue();
+
 	if (ShouldRender())
 	{
 		ImGui::SetNextWindowSize(ImVec2(765.0f, 455.0f), ImGuiCond_Once);
@@ -834,6 +4966,16 @@ void ImTerminal::OnRender()
 		{
 			SetIsFocused(ImGui::IsWindowFocused());
 
+			if (DroppedSnapshot > 0)
+			{
+				ImExtensions::TextColored(("Dropped " + std::to_string(DroppedSnapshot) + " lines (" + std::to_string(DroppedLastFrame) + " last frame), the log queue is full.").c_str(), ImColorMap[TextColors::Red]);
+				ImGui::SameLine(); ImGui::TextDisabled("Peak backlog %zu / %zu lines.", PeakBacklog, ConsoleQueue.GetCapacity());
+			}
+			else if (PeakBacklog > (ConsoleQueue.GetCapacity() / 4))
+			{
+				ImGui::TextDisabled("Log queue peaked at %zu / %zu lines.", PeakBacklog, ConsoleQueue.GetCapacity());
+			}
+
 			bool copy_to_clipboard = false;
 			const float footer_height_to_reserve = ImGui::GetStyle().ItemSpacing.y + ImGui::GetFrameHeightWithSpacing();
 
@@ -843,37 +4985,68 @@ void ImTerminal::OnRender()
 				{
 					if (ImGui::BeginMenu("Filter Text###Terminal_FilterMenu"))
 					{
-						Filter.Draw("Filter: (\"incl,-excl\") (\"error\")###Terminal_Filter", (ImGui::GetWindowSize().x / 4.0f));
+						if (Filter.Draw("Filter: (\"incl,-excl\") (\"error\")###Terminal_Filter", (ImGui::GetWindowSize().x / 4.0f))) { InvalidateLines(); }
 						ImGui::EndMenu();
 					}
 
 					ImGui::MenuItem("Auto Scroll", "", &AutoScroll);
+					ImGui::MenuItem("Fuzzy Complete", "", &FuzzyComplete);
 					copy_to_clipboard = ImGui::Selectable("Copy to Clipboard");
-					if (ImGui::Selectable("Clear Terminal###Terminal_ClearText")) { ConsoleText.clear(); }
+					if (ImGui::Selectable("Clear Terminal###Terminal_ClearText"))
+					{
+						ConsoleText.Clear();
+						ConsoleQueue.ResetDropped();
+						DroppedSnapshot = 0;
+						DroppedLastFrame = 0;
+						PeakBacklog = 0;
+					}
 					if (ImGui::Selectable("Clear History###Terminal_ClearHistory")) { UserHistory.clear(); }
 
 					ImGui::EndPopup();
 				}
 
 				ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(4.0f, 1.0f));
-				if (copy_to_clipboard) { ImGui::LogToClipboard(); }
+				UpdateLines();
 
-				for (size_t i = 0; i < ConsoleText.size(); i++)
+				if (copy_to_clipboard)
 				{
-					const ImClasses::TextData& textData = ConsoleText[i];
-					const char* itemText = textData.Text.c_str();
-					if (!Filter.PassFilter(itemText)) { continue; }
+					// Only the visible lines are submitted below, so ImGui's logging would miss the rest.
+					std::string clipboardText;
+
+					for (uint64_t id : FilteredLines)
+					{
+						clipboardText += ConsoleText.GetText(ConsoleText[static_cast<size_t>(id - ConsoleText.GetFirstId())]);
+						clipboardText += '\n';
+					}
+
+					ImGui::SetClipboardText(clipboardText.c_str());
+				}
+
+				// Only the lines that passed the filter are laid out, so this never touches anything but what's on screen.
+				float startY = ImGui::GetCursorPosY();
+				uint64_t firstId = ConsoleText.GetFirstId();
+				uint64_t firstMatch = ConsoleLayout.GetFirstId();
+				uint64_t endMatch = std::min((ConsoleLayout.FindLine(ImGui::GetScrollY() + ImGui::GetWindowHeight() - startY) + 1), ConsoleLayout.GetEndId());
+
+				for (uint64_t match = ConsoleLayout.FindLine(ImGui::GetScrollY() - startY); match < endMatch; match++)
+				{
+					const ImClasses::TextLog::LineRecord& line = ConsoleText[static_cast<size_t>(FilteredLines[static_cast<size_t>(match - firstMatch)] - firstId)];
+					const char* itemText = ConsoleText.GetText(line);
 
 					float fontSize = 1.0f;
-					ImFont* font = ImFontMap[textData.Style];
+					ImFont* font = ImFontMap[line.Style];
 					if (font) { fontSize = font->FontSize; }
 
+					ImGui::SetCursorPosY(startY + ConsoleLayout.GetTop(match));
 					ImGui::PushTextWrapPos(ImGui::GetWindowWidth() - fontSize);
-					ImExtensions::TextStyled(itemText, textData.Color, font);
+					ImExtensions::TextStyled(itemText, ConsoleText.GetColor(line), font);
 					ImGui::PopTextWrapPos();
 				}
 
-				if (copy_to_clipboard) { ImGui::LogFinish(); }
+				// Stand-in for the last line, so the content size and "SetScrollHereY" come out the same as if every line had been submitted.
+				ImGui::SetCursorPosY(startY + std::max((ConsoleLayout.GetHeight() - ImGui::GetStyle().ItemSpacing.y), 0.0f));
+				ImGui::Dummy(ImVec2(0.0f, 0.0f));
+
 				if (ScrollToBottom || (AutoScroll && (ImGui::GetScrollY() >= ImGui::GetScrollMaxY()))) { ImGui::SetScrollHereY(1.0f); }
 
 				ScrollToBottom = false;
@@ -951,6 +5124,8 @@ void ImTerminal::OnRender()
 									));
 								}
 
+								if (CandidateTotal > Candidates.size()) { ImGui::TextDisabled("%zu more...", (CandidateTotal - Candidates.size())); }
+
 								ImGui::EndChild();
 							}
 
@@ -973,127 +5148,68 @@ void ImTerminal::SetHistorySize(size_t newSize)
 	if (newSize <= 5120)
 	{
 		MaxConsoleHistory = newSize;
+		ConsoleText.SetCapacity(MaxConsoleHistory);
 	}
 }
 
 void ImTerminal::AddCommand(const std::string& str)
 {
-	CommandCompletes.push_back(ImExtensions::StrCpy(str.c_str()));
+	CommandCompletes.Add(str);
 }
 
 void ImTerminal::RemoveCommand(const std::string& str)
 {
-	for (size_t i = 0; i < CommandCompletes.size(); i++)
-	{
-		if (std::string(CommandCompletes[i]) == str)
-		{
-			free(CommandCompletes[i]);
-			CommandCompletes[i] = nullptr;
-			break;
-		}
-	}
-
-	for (auto completeIt = CommandCompletes.begin(); completeIt != CommandCompletes.end();)
-	{
-		if (*completeIt == nullptr)
-		{
-			completeIt = CommandCompletes.erase(completeIt);
-		}
-		else
-		{
-			completeIt++;
-		}
-	}
+	CommandCompletes.Remove(str);
 }
 
 void ImTerminal::ClearCommands()
 {
-	for (size_t i = 0; i < CommandCompletes.size(); i++)
-	{
-		if (CommandCompletes[i])
-		{
-			free(CommandCompletes[i]);
-		}
-	}
-
-	CommandCompletes.clear();
+	CommandCompletes.Clear();
 }
 
 void ImTerminal::AddArgument(ImArgumentIds argumentId, const std::string& str)
 {
-	if (ArgumentCompletes.find(argumentId) != ArgumentCompletes.end())
-	{
-		ArgumentCompletes[argumentId].push_back(str);
-	}
-	else
-	{
-		ArgumentCompletes[argumentId] = std::vector<std::string>{ str };
-	}
+	ArgumentCompletes[argumentId].Add(str);
 }
 
 void ImTerminal::RemoveArgument(ImArgumentIds argumentId, const std::string& str)
 {
-	if (ArgumentCompletes.find(argumentId) != ArgumentCompletes.end())
-	{
-		std::vector<std::string>& arguments = ArgumentCompletes[argumentId];
-		std::vector<std::string>::iterator argumentIt = std::find(arguments.begin(), arguments.end(), str);
+	std::map<ImArgumentIds, ImClasses::CompletionIndex>::iterator argumentIt = ArgumentCompletes.find(argumentId);
 
-		if (argumentIt != arguments.end())
-		{
-			arguments.erase(argumentIt);
-		}
+	if (argumentIt != ArgumentCompletes.end())
+	{
+		argumentIt->second.Remove(str);
 	}
 }
 
 void ImTerminal::AddDisplayText(const std::string& text, TextColors textColor, TextStyles textStyle)
 {
-	ImClasses::TextData newData(text, textColor, textStyle);
-
-	if (ConsoleText.size() >= MaxConsoleHistory)
-	{
-		for (size_t i = 0; i < ConsoleText.size(); i++)
-		{
-			if (i == 0)
-			{
-				continue;
-			}
-
-			ConsoleText[i - 1] = ConsoleText[i];
-		}
-
-		ConsoleText[ConsoleText.size() - 1] = newData;
-	}
-	else
-	{
-		ConsoleText.push_back(newData);
-	}
+	AddDisplayText(ImClasses::QueueData(text, textColor, textStyle));
 }
 
 void ImTerminal::AddDisplayText(const ImClasses::QueueData& queueData)
 {
-	AddDisplayText(queueData.Text, queueData.Id, queueData.Style);
+	// Only a slot write, if the queue is full the line is dropped and counted instead of waiting on the render thread.
+	ConsoleQueue.Push(queueData);
 }
 
 void ImTerminal::ConsoleDelegate(const std::string& text, TextColors textColor, TextStyles textStyle)
 {
-	if (true) // In CodeRed this is where I check if DirectX has been hooked yet or not, if it isn't and this function is called I add it to a "queue" to display later on.
-	{
-		if (!ConsoleQueue.empty())
-		{
-			for (size_t i = 0; i < ConsoleQueue.size(); i++)
-			{
-				AddDisplayText(ConsoleQueue[i]);
-			}
-
-			ConsoleQueue.clear();
-		}
+	// In CodeRed this is where I used to check if DirectX has been hooked yet, lines now wait in "ConsoleQueue" until the first "OnRender" anyway.
+	AddDisplayText(text, textColor, textStyle);
+}
 
-		AddDisplayText(text, textColor, textStyle);
-	}
-	else
-	{
-		ConsoleQueue.push_back(ImClasses::QueueData(text, textColor, textStyle));
-	}
+void ImTerminal::DrainQueue()
+{
+	// Bounded by the queue's capacity so a logging flood can only ever cost one queue's worth of lines per frame.
+	size_t drained = ConsoleQueue.Drain([](const ImClasses::QueueData& queueData) {
+		ConsoleText.Push(queueData.Text, queueData.Id, queueData.Style);
+	}, ConsoleQueue.GetCapacity());
+
+	size_t dropped = ConsoleQueue.GetDropped();
+	DroppedLastFrame = (dropped - DroppedSnapshot);
+	DroppedSnapshot = dropped;
+	PeakBacklog = std::max(PeakBacklog, drained);
 }
 
 void ImTerminal::ExecuteCommand(const std::string& command, TextStyles textStyle)
@@ -1115,7 +5231,7 @@ void ImTerminal::ExecuteCommand(const std::string& command, TextStyles textStyle
 			UserHistory[i - 1] = UserHistory[i];
 		}
 
-		UserHistory[ConsoleText.size() - 1] = command;
+		UserHistory[UserHistory.size() - 1] = command;
 	}
 	else
 	{
@@ -1130,10 +5246,93 @@ void ImTerminal::ExecuteCommand(const std::string& command, TextStyles textStyle
 void ImTerminal::ResetAutoComplete()
 {
 	CandidatePos = 0;
+	CandidateTotal = 0;
 	ArgumentType = ImArgumentIds::IM_None;
 	Candidates.clear();
 }
 
+void ImTerminal::FindCandidates(ImClasses::CompletionIndex& completes, const char* word, size_t length)
+{
+	// Only the words that can be shown are copied out, the index itself does the rest.
+	std::vector<const std::string*> results;
+	CandidateTotal = (FuzzyComplete ? completes.FindFuzzy(word, length, MaxCandidates, results) : completes.FindPrefix(word, length, MaxCandidates, results));
+
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		Candidates.push_back(std::make_pair(*results[i], (i == 0)));
+	}
+}
+
+void ImTerminal::InvalidateLines()
+{
+	FilteredLines.clear();
+	FilteredEnd = ConsoleText.GetFirstId();
+	ConsoleLayout.Reset(0);
+}
+
+void ImTerminal::UpdateLines()
+{
+	float width = ImGui::GetWindowWidth();
+	float indent = (ImGui::GetCursorScreenPos().x - ImGui::GetWindowPos().x);
+	ImFont* font = ImGui::GetFont();
+	float fontSize = ImGui::GetFontSize();
+
+	// Evicted IDs can only ever be at the front, so this never touches more than what was just evicted.
+	// Has to happen before any relayout below, those IDs no longer have a line in "ConsoleText" to measure.
+	size_t trimmed = 0;
+
+	while (!FilteredLines.empty() && (FilteredLines.front() < ConsoleText.GetFirstId()))
+	{
+		FilteredLines.pop_front();
+		trimmed++;
+	}
+
+	ConsoleLayout.Trim(ConsoleLayout.GetFirstId() + trimmed);
+
+	// Wrapped heights only depend on the region's width and the font, so lines are measured once and then only when one of those changes.
+	if ((width != LayoutWidth) || (indent != LayoutIndent) || (font != LayoutFont) || (fontSize != LayoutFontSize))
+	{
+		LayoutWidth = width;
+		LayoutIndent = indent;
+		LayoutFont = font;
+		LayoutFontSize = fontSize;
+		ConsoleLayout.Reset(ConsoleLayout.GetFirstId());
+
+		for (uint64_t id : FilteredLines)
+		{
+			ConsoleLayout.Append(GetLineHeight(ConsoleText[static_cast<size_t>(id - ConsoleText.GetFirstId())]));
+		}
+	}
+
+	// Lines are only ever appended, so only the new ones need to be checked unless the filter text changed.
+	for (FilteredEnd = std::max(FilteredEnd, ConsoleText.GetFirstId()); FilteredEnd < ConsoleText.GetEndId(); FilteredEnd++)
+	{
+		const ImClasses::TextLog::LineRecord& line = ConsoleText[static_cast<size_t>(FilteredEnd - ConsoleText.GetFirstId())];
+		const char* text = ConsoleText.GetText(line);
+
+		if (Filter.PassFilter(text, (text + line.Length)))
+		{
+			FilteredLines.push_back(FilteredEnd);
+			ConsoleLayout.Append(GetLineHeight(line));
+		}
+	}
+}
+
+float ImTerminal::GetLineHeight(const ImClasses::TextLog::LineRecord& line) const
+{
+	const char* text = ConsoleText.GetText(line);
+
+	// Same wrap width "TextEx" ends up with for the wrap position "OnRender" pushes.
+	ImFont* font = ImFontMap[line.Style];
+	float wrapWidth = std::max((LayoutWidth - (font ? font->FontSize : 1.0f) - LayoutIndent), 1.0f);
+
+	if (font) { ImGui::PushFont(font); }
+	float height = ImGui::CalcTextSize(text, (text + line.Length), false, wrapWidth).y;
+	if (font) { ImGui::PopFont(); }
+
+	return (height + ImGui::GetStyle().ItemSpacing.y);
+}
+
 int32_t ImTerminal::TextEditCallback(ImGuiInputTextCallbackData* data)
 {
 	switch (data->EventFlag)
@@ -1275,19 +5474,7 @@ int32_t ImTerminal::TextEditCallback(ImGuiInputTextCallbackData* data)
 			{
 				if (!isArgument)
 				{
-					bool first = true;
-
-					for (size_t i = 0; i < CommandCompletes.size(); i++)
-					{
-						if (CommandCompletes[i])
-						{
-							if (ImExtensions::Strnicmp(CommandCompletes[i], word_start, (int32_t)(word_end - word_start)) == 0)
-							{
-								Candidates.push_back(std::make_pair(CommandCompletes[i], first));
-								first = false;
-							}
-						}
-					}
+					FindCandidates(CommandCompletes, word_start, (size_t)(word_end - word_start));
 				}
 				else
 				{
@@ -1330,20 +5517,11 @@ int32_t ImTerminal::TextEditCallback(ImGuiInputTextCallbackData* data)
 						break;
 					}
 
-					if (ArgumentCompletes.find(ArgumentType) != ArgumentCompletes.end())
-					{
-						bool first = true;
-
-						const std::vector<std::string>& completes = ArgumentCompletes[ArgumentType];
+					std::map<ImArgumentIds, ImClasses::CompletionIndex>::iterator completesIt = ArgumentCompletes.find(ArgumentType);
 
-						for (size_t i = 0; i < completes.size(); i++)
-						{
-							if (ImExtensions::Strnicmp(completes[i].c_str(), argument_start, (int32_t)(argument_end - argument_start)) == 0)
-							{
-								Candidates.push_back(std::make_pair(completes[i].c_str(), first));
-								first = false;
-							}
-						}
+					if (completesIt != ArgumentCompletes.end())
+					{
+						FindCandidates(completesIt->second, argument_start, (size_t)(argument_end - argument_start));
 					}
 				}
 			}
@@ -1,6 +1,9 @@
 #pragma once
 #include "pch.hpp"
 
+class UObject; // Provided by your game's SDK.
+class UFunction; // Provided by your game's SDK.
+
 enum class ImArgumentIds : uint8_t
 {
 	IM_None,
@@ -32,6 +35,69 @@ enum class TextColors : uint32_t
 	END
 };
 
+enum class FunctionColumns : uint32_t
+{
+	Calls,
+	Package,
+	Caller,
+	Function,
+	TotalTime,
+	AverageTime,
+	P99Time,
+	MaxTime,
+	RateWindow1, // Averaged over "ImFunctionScanner::RateWindows[0]" seconds, the next two use the windows after it.
+	RateWindow2,
+	RateWindow3,
+	RateHistory,
+	END
+};
+
+enum class DiffColumns : uint32_t
+{
+	Status,
+	Function,
+	BaselineCalls,
+	CurrentCalls,
+	BaselineRate,
+	CurrentRate,
+	Change,
+	END
+};
+
+enum class DiffStatuses : uint8_t
+{
+	Unchanged,
+	Changed, // Call rate moved by more than the threshold.
+	Appeared, // Only in the current session.
+	Vanished, // Only in the baseline.
+	END
+};
+
+enum class CapturePolicies : uint8_t
+{
+	Every, // Every event is captured.
+	OneInN, // Every Nth event per thread is captured, counted N times.
+	Reservoir, // Every event is counted, but history keeps a fixed-size uniform sample.
+	TokenBucket, // Each function is capped to a number of events per second, skipped events are folded into the next captured one.
+	END
+};
+
+enum class ExportFormats : uint8_t
+{
+	Clipboard, // Full names, one per line.
+	Csv,
+	JsonLines,
+	Flamegraph, // Folded stacks of the call graph, one "Package;Caller;Function count" line per leaf.
+	END
+};
+
+enum class FilterStates : uint8_t
+{
+	Unknown, // Not checked against the current filters yet.
+	Accepted,
+	Rejected
+};
+
 enum class CornerPositions : uint8_t
 {
 	Custom,
@@ -71,6 +137,7 @@ namespace ImClasses
 		TextStyles Style;
 
 	public:
+		TextData();
 		TextData(const std::string& text, TextColors textColor, TextStyles textStyle);
 		~TextData();
 
@@ -84,6 +151,7 @@ namespace ImClasses
 		TextColors Id;
 
 	public:
+		QueueData();
 		QueueData(const std::string& text, TextColors textColor, TextStyles textStyle);
 		~QueueData();
 
@@ -91,35 +159,1070 @@ namespace ImClasses
 		QueueData& operator=(const QueueData& queueData);
 	};
 
-	class FunctionCount
+	// Stores each distinct name once, looked up by the owning object's index so repeat events never build or copy strings.
+	class NameTable
 	{
 	public:
-		size_t Calls;
+		static constexpr uint32_t NullId = 0; // Always maps to "null".
+
+	private:
+		std::deque<std::string> Names; // Deque so the views below stay valid as it grows.
+		std::unordered_map<uint64_t, uint32_t> IndexIds; // Object index in the low half and its generation in the high half, indices get reused once an object is garbage collected.
+		std::unordered_map<std::string_view, uint32_t> TextIds;
+		size_t StringBytes;
 
 	public:
-		FunctionCount();
-		~FunctionCount();
+		NameTable();
+		~NameTable();
+
+	public:
+		uint32_t Find(int32_t objectIndex, uint32_t generation = 0) const;
+		uint32_t Intern(const std::string& name);
+		uint32_t Intern(int32_t objectIndex, const std::string& name, uint32_t generation = 0);
+		const std::string& Get(uint32_t id) const;
+		size_t Size() const;
+		size_t GetBytes() const;
+		void Clear();
+
+	public:
+		// Only calls "getName" the first time an object index (and generation) is seen.
+		template <typename Fn>
+		uint32_t Resolve(int32_t objectIndex, Fn&& getName, uint32_t generation = 0)
+		{
+			uint32_t id = Find(objectIndex, generation);
+			return ((id != NullId) ? id : Intern(objectIndex, getName(), generation));
+		}
+
+	private:
+		static uint64_t GetKey(int32_t objectIndex, uint32_t generation);
 	};
 
-	class FunctionData : public FunctionCount
+	// Open-addressing hash from an object index to a dense row slot, linear probing over a power of two table.
+	class IndexMap
 	{
 	public:
-		std::string FullName;
-		std::string Package;
-		std::string Caller;
-		std::string Function;
+		static constexpr uint32_t InvalidSlot = UINT32_MAX;
+
+	private:
+		struct Bucket
+		{
+			int32_t Key;
+			uint32_t Slot; // "InvalidSlot" if the bucket is empty.
+		};
+
+	private:
+		std::vector<Bucket> Buckets;
+		size_t Mask;
+		size_t Count;
+
+	public:
+		IndexMap();
+		~IndexMap();
+
+	public:
+		uint32_t Find(int32_t key) const;
+		uint32_t FindOrInsert(int32_t key, uint32_t slot, bool& bInserted);
+		size_t Size() const;
+		size_t GetBytes() const;
+		void Reserve(size_t count);
+		void Clear();
+
+	private:
+		static size_t Hash(int32_t key);
+		void Rehash(size_t bucketCount);
+	};
+
+	// Every term of one or more "ImGuiTextFilter"s compiled into a single case-folded Aho-Corasick automaton, so a name is scanned once no matter how many terms there are.
+	// Follows "ImGuiTextFilter::PassFilter" exactly, terms are comma separated, a leading '-' excludes, and the first matching term in the list decides.
+	class TextMatcher
+	{
+	public:
+		static constexpr size_t MaxFilters = 32;
+
+	private:
+		static constexpr uint16_t NoTerm = UINT16_MAX;
+
+	private:
+		std::array<uint8_t, 256> CharClasses; // Byte to its column in "Transitions", both cases share a column and bytes no term uses share column zero.
+		size_t ClassCount;
+		size_t FilterCount;
+		std::vector<uint32_t> Transitions; // Dense "StateCount x ClassCount" table with failure links already folded in.
+		std::vector<uint16_t> FirstTerms; // "StateCount x FilterCount", lowest term index of each filter that ends at this state or any of its suffixes.
+		std::vector<uint8_t> Outputs; // Per state, set if any term ends at it so most characters skip the "FirstTerms" check.
+		std::vector<std::vector<uint8_t>> Excludes; // Per filter, per term.
+		uint32_t ImplicitMask; // Filters with no include terms, these pass when nothing matches.
+
+	public:
+		TextMatcher();
+		~TextMatcher();
+
+	public:
+		void Compile(const std::vector<const ImGuiTextFilter*>& filters); // Call whenever any of the filter texts change, terms are copied so the filters can be edited freely afterwards.
+		uint32_t Match(const char* text, size_t length) const; // Bit "i" is set if "filters[i]" passes.
+		size_t GetStateCount() const;
+		size_t GetBytes() const;
+	};
+
+	// Filter result per function index packed two bits each, read lock-free from any thread but only ever written by the render thread.
+	class FilterBits
+	{
+	private:
+		std::unique_ptr<std::atomic<uint64_t>[]> Words;
+		size_t Capacity; // Indices past this are always "FilterStates::Unknown".
+
+	public:
+		FilterBits();
+		~FilterBits();
+
+	public:
+		void Reserve(size_t capacity); // Must not be called while other threads are reading.
+		void Set(int32_t index, FilterStates state);
+		void Clear(); // Everything goes back to "FilterStates::Unknown".
+		size_t GetBytes() const;
+
+	public:
+		FilterStates Get(int32_t index) const
+		{
+			if ((index < 0) || (static_cast<size_t>(index) >= Capacity))
+			{
+				return FilterStates::Unknown;
+			}
+
+			uint64_t word = Words[static_cast<size_t>(index) >> 5].load(std::memory_order_relaxed);
+			return static_cast<FilterStates>((word >> ((index & 31) * 2)) & 3);
+		}
+	};
+
+	// Object indices behind a single call, what an "EventSource" hands out in place of live UObject/UFunction pointers.
+	struct SourceEvent
+	{
+		int32_t Function;
+		int32_t Caller;
+		int32_t Package; // Package the function belongs to.
+	};
+
+	// Supplies events and the names behind their object indices, lets the capture path run without the game SDK.
+	class EventSource
+	{
+	public:
+		EventSource();
+		virtual ~EventSource();
+
+	public:
+		virtual bool Next(SourceEvent& sourceEvent) = 0; // Returns false once the source has run dry.
+		virtual std::string GetFullName(int32_t functionIndex) const = 0;
+		virtual std::string GetObjectName(int32_t objectIndex) const = 0;
+	};
+
+	class FunctionEvent;
+
+	class FunctionData
+	{
+	private:
+		struct FunctionNames
+		{
+			uint32_t FullName;
+			uint32_t Package;
+			uint32_t Function;
+		};
+
+	public:
+		static inline NameTable FullNames; // Keyed by the UFunction's index.
+		static inline NameTable ObjectNames; // Keyed by the index of the package, caller, or function object.
+
+	private:
+		static inline IndexMap ResolvedSlots; // Function index to its entry in "ResolvedFunctions".
+		static inline std::vector<FunctionNames> ResolvedFunctions; // Everything a function contributes, so repeat calls never touch the UFunction again.
+
+	public:
+		uint32_t FullName;
+		uint32_t Package;
+		uint32_t Caller;
+		uint32_t Function;
 		int32_t Index;
+		uint32_t Frame; // Value of "ImFunctionScanner::FrameCounter" when the event was captured.
+		uint64_t Timestamp; // Nanoseconds, steady clock.
 
 	public:
 		FunctionData();
 		FunctionData(const FunctionData& functionData);
 		FunctionData(class UObject* caller, class UFunction* function);
+		FunctionData(const EventSource& source, const SourceEvent& sourceEvent);
+		FunctionData(const FunctionEvent& functionEvent); // Only dereferences the event's pointers the first time its function or caller is seen.
 		FunctionData(const std::string& fullName, const std::string& package, const std::string& caller, const std::string& function, int32_t index);
 		~FunctionData();
 
+	public:
+		const std::string& GetFullName() const;
+		const std::string& GetPackage() const;
+		const std::string& GetCaller() const;
+		const std::string& GetFunction() const;
+		static void ClearNames();
+
 	public:
 		FunctionData& operator=(const FunctionData& functionData);
 	};
+
+	class FunctionCount : public FunctionData
+	{
+	public:
+		size_t Calls;
+
+	public:
+		FunctionCount();
+		FunctionCount(const FunctionData& functionData);
+		~FunctionCount();
+	};
+
+	// On-disk layout of a binary function capture, every section is 8 byte aligned so the file can be memory-mapped and read in place.
+	// [CaptureHeader] [CaptureRecord x RecordCount] [CaptureFunction x FunctionCount] [full name table] [object name table] [CaptureFooter]
+	// A name table is "count + 1" uint64 offsets relative to the end of the offset array, followed by the packed (not null terminated) string bytes.
+	namespace CaptureFormat
+	{
+		static constexpr uint32_t Magic = 0x50414352; // "RCAP"
+		static constexpr uint32_t Version = 2; // 2 added "CaptureFooter::Duration".
+		static constexpr uint32_t OldestVersion = 1; // Oldest version "CaptureFile" still reads, version 1 footers are 8 bytes shorter and have no duration.
+	}
+
+	struct CaptureHeader
+	{
+		uint32_t Magic;
+		uint32_t Version;
+		uint32_t RecordSize;
+		uint32_t FunctionSize;
+	};
+
+	struct CaptureRecord
+	{
+		uint32_t FullName;
+		uint32_t Package;
+		uint32_t Caller;
+		uint32_t Function;
+		int32_t Index;
+		uint32_t Frame; // Always zero in files written before frames were tracked.
+		uint64_t Timestamp;
+	};
+
+	struct CaptureFunction
+	{
+		uint32_t FullName;
+		uint32_t Package;
+		uint32_t Caller;
+		uint32_t Function;
+		int32_t Index;
+		uint32_t Reserved;
+		uint64_t Calls;
+	};
+
+	struct CaptureFooter
+	{
+		uint64_t RecordsOffset;
+		uint64_t RecordCount;
+		uint64_t FunctionsOffset;
+		uint64_t FunctionCount;
+		uint64_t FullNamesOffset;
+		uint64_t FullNameCount;
+		uint64_t ObjectNamesOffset;
+		uint64_t ObjectNameCount;
+		uint64_t Duration; // Nanoseconds the function call totals were counted over.
+		uint32_t Magic;
+		uint32_t Version;
+	};
+
+	static_assert(sizeof(CaptureRecord) == 32, "CaptureRecord must stay fixed-width.");
+	static_assert(sizeof(CaptureFunction) == 32, "CaptureFunction must stay fixed-width.");
+	static_assert(sizeof(CaptureFooter) == 80, "CaptureFooter must stay fixed-width.");
+
+	// A run of events another thread can read while the history keeps going, shared blocks are copied before they're written to again.
+	struct SharedRecords
+	{
+		std::shared_ptr<const FunctionData[]> Records;
+		size_t Count;
+	};
+
+	// Streams capture records to disk on a background thread, the caller fills one block while the writer thread flushes the other.
+	class CaptureWriter
+	{
+	public:
+		static constexpr size_t BlockRecords = 16384;
+
+	private:
+		std::ofstream File;
+		std::thread Thread;
+		std::mutex Mutex;
+		std::condition_variable Signal;
+		std::vector<CaptureRecord> FrontBlock; // Filled by the caller.
+		std::vector<CaptureRecord> BackBlock; // Owned by the writer thread while "BackPending" is set, swapped back empty so neither block reallocates.
+		std::vector<SharedRecords> Chunks; // Handed over by "Submit", converted to records on the writer thread.
+		bool BackPending;
+		bool Closing;
+		std::vector<CaptureFunction> TailFunctions;
+		std::vector<std::string_view> TailFullNames; // Views into "FunctionData::FullNames" until "DetachNames" is called.
+		std::vector<std::string_view> TailObjectNames;
+		std::deque<std::string> DetachedNames; // Backs the views above once the name tables are about to be cleared.
+		std::mutex NamesMutex; // Held by the writer thread while it writes the tail.
+		bool NamesWritten;
+		uint64_t TailDuration;
+		std::atomic<bool> Active; // Set from "Open" until the writer thread has written the footer and closed the file.
+		std::atomic<uint64_t> RecordsWritten;
+		std::atomic<uint64_t> RecordsDropped; // Appended while both blocks were full, never waited on.
+
+	public:
+		CaptureWriter();
+		~CaptureWriter();
+
+	public:
+		bool Open(const std::string& filePath);
+		void Append(const FunctionData& functionData); // Never blocks, records are dropped if the disk has fallen a whole block behind.
+		void Submit(std::vector<SharedRecords>&& chunks);
+		void Close(const std::vector<FunctionCount>& functions, uint64_t duration); // Never blocks, the writer thread finishes the file on its own.
+		void DetachNames(); // Call before the name tables are cleared, copies the names only if the tail hasn't been written yet.
+		bool IsActive() const;
+		uint64_t GetRecordsWritten() const;
+		uint64_t GetRecordsDropped() const;
+
+	public:
+		static CaptureRecord ToRecord(const FunctionData& functionData);
+
+	private:
+		void WriterThread();
+		void WriteChunk(const SharedRecords& chunk, std::vector<CaptureRecord>& records);
+		void WriteNames(const std::vector<std::string_view>& names);
+		void WriteTail();
+		void Pad();
+	};
+
+	// Read-only memory-mapped view of a capture written by "CaptureWriter", nothing is copied on load.
+	class CaptureFile
+	{
+	private:
+		HANDLE FileHandle;
+		HANDLE MappingHandle;
+		const uint8_t* View;
+		size_t ViewSize;
+		CaptureFooter Footer; // Copied out of the file so older, shorter footers can be widened, "Duration" is zero when the file didn't have one.
+
+	public:
+		CaptureFile();
+		~CaptureFile();
+
+	public:
+		bool Open(const std::string& filePath);
+		void Close();
+		bool IsOpen() const;
+		size_t GetRecordCount() const;
+		const CaptureRecord* GetRecords() const;
+		size_t GetFunctionCount() const;
+		const CaptureFunction* GetFunctions() const;
+		uint64_t GetDuration() const;
+		std::string_view GetFullName(uint32_t id) const;
+		std::string_view GetObjectName(uint32_t id) const;
+
+	private:
+		bool ValidateNames(uint64_t offset, uint64_t count) const;
+		bool ValidateRange(uint64_t offset, uint64_t count, uint64_t elementSize) const; // Written to never overflow, the footer may be corrupt.
+		std::string_view GetName(uint64_t offset, uint64_t count, uint32_t id) const;
+	};
+
+	// One row of the baseline diff, either side can be missing.
+	struct FunctionDiff
+	{
+		uint32_t BaselineRow; // Into "CaptureFile::GetFunctions", "IndexMap::InvalidSlot" if the function appeared.
+		uint32_t Slot; // Into "ImFunctionScanner::FunctionMap", "IndexMap::InvalidSlot" if the function vanished.
+		float BaselineRate; // Calls per second.
+		float CurrentRate;
+		float Change; // Percent, relative to the baseline rate.
+		DiffStatuses Status;
+	};
+
+	// Captured events in fixed-size blocks, each event gets a stable ID that stays valid until its block is evicted to stay under the memory cap.
+	class HistoryStore
+	{
+	public:
+		static constexpr size_t BlockRecords = 8192;
+		static constexpr size_t BlockBytes = (BlockRecords * sizeof(FunctionData));
+
+	private:
+		std::deque<std::shared_ptr<FunctionData[]>> Blocks; // Shared with "Share" callers, a block is copied before it's written to while they still hold it.
+		std::shared_ptr<FunctionData[]> SpareBlock; // Last evicted block, reused so steady state eviction doesn't allocate.
+		uint64_t FirstId; // ID of the oldest retained event, always the start of a block.
+		uint64_t EndId; // ID the next event will get.
+		uint64_t Evicted;
+		size_t MemoryCap; // Bytes, the block being written to is always kept.
+
+	public:
+		HistoryStore();
+		~HistoryStore();
+
+	public:
+		uint64_t Push(const FunctionData& functionData);
+		const FunctionData& operator[](uint64_t id) const;
+		void Set(uint64_t id, const FunctionData& functionData);
+		std::vector<SharedRecords> Share() const; // Every retained event in order, without copying any of them.
+		bool Contains(uint64_t id) const;
+		bool Empty() const;
+		size_t Size() const;
+		uint64_t GetFirstId() const;
+		uint64_t GetEndId() const;
+		uint64_t GetEvicted() const;
+		size_t GetBytes() const;
+		size_t GetMemoryCap() const;
+		void SetMemoryCap(size_t bytes);
+		void Truncate(size_t size); // Drops the newest events past "size", they're counted as evicted.
+		void Clear();
+		static size_t GetRecordCapacity(size_t memoryCap); // Most events that fit under a cap, never less than the one block that's always kept.
+
+	private:
+		FunctionData* GetWritableBlock(size_t block);
+		void Evict();
+	};
+
+	// Fixed-size record written by the game thread, names are resolved later when the render thread drains it.
+	class FunctionEvent
+	{
+	public:
+		class UObject* Caller;
+		class UFunction* Function;
+		uint64_t Timestamp; // "EventClock" ticks.
+		uint64_t Duration; // "EventClock" ticks spent inside the hooked call, zero if it wasn't timed.
+		uint32_t Weight; // How many real calls this event stands for when sampling, so totals stay unbiased.
+		int32_t FunctionIndex;
+		int32_t CallerIndex;
+		uint32_t CallerGeneration; // Serial number of the caller's object slot, tells apart objects that reused the same index.
+		uint32_t Frame;
+
+	public:
+		FunctionEvent();
+		FunctionEvent(class UObject* caller, class UFunction* function, int32_t functionIndex, int32_t callerIndex, uint32_t callerGeneration, uint32_t frame, uint64_t timestamp, uint64_t duration, uint32_t weight = 1);
+		~FunctionEvent();
+	};
+
+	// Monotonic tick source for event timestamps and durations, the TSC where available calibrated once against the steady clock.
+	class EventClock
+	{
+	private:
+		static inline double NanosecondsPerTick = 1.0;
+
+	public:
+		static uint64_t Now()
+		{
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+			return __rdtsc();
+#else
+			return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+		}
+
+		static uint64_t ToNanoseconds(uint64_t ticks)
+		{
+			return static_cast<uint64_t>(static_cast<double>(ticks) * NanosecondsPerTick);
+		}
+
+		static double GetTicksPerSecond()
+		{
+			return (1000000000.0 / NanosecondsPerTick);
+		}
+
+		static void Calibrate();
+	};
+
+	// Rate limiter for a single function, shared by every thread that calls it. The budget is kept as the tick the next call is due at, so a single CAS takes a token.
+	class TokenBucket
+	{
+	public:
+		std::atomic<class UFunction*> Owner; // Claimed by the first function to use the bucket, never changes after that.
+		std::atomic<uint64_t> DueTicks; // Calls are let through up to "capacity" tokens ahead of this, each one pushes it back by a token's worth of ticks.
+		std::atomic<uint32_t> Skipped; // Calls rejected since the last one that was let through.
+
+	public:
+		TokenBucket();
+		~TokenBucket();
+
+	public:
+		bool Claim(class UFunction* function); // False if another function already owns the bucket.
+		bool TryConsume(uint64_t nowTicks, double ticksPerToken, double capacity, uint32_t& weight);
+	};
+
+	// Calls per second for a single function over the last minute, one counter per second reused as a ring so each event is O(1).
+	class FunctionRate
+	{
+	public:
+		static constexpr size_t HistorySeconds = 60; // Longest window that can be asked for.
+		static constexpr size_t BucketCount = (HistorySeconds + 1); // Plus the second that's still in progress.
+
+	public:
+		uint64_t LastSecond; // Second the newest bucket belongs to.
+		std::array<uint32_t, BucketCount> Buckets;
+
+	public:
+		FunctionRate();
+		~FunctionRate();
+
+	public:
+		void Add(uint64_t second, uint32_t calls = 1);
+		uint32_t GetCalls(uint64_t second) const;
+		float GetRate(uint64_t nowSecond, size_t windowSeconds) const;
+		void GetHistory(uint64_t nowSecond, float* values) const; // Fills "HistorySeconds" values, oldest first.
+	};
+
+	// Inclusive time spent in a single function, kept as a log-linear histogram (two buckets per power of two) so percentiles are cheap.
+	class FunctionTiming
+	{
+	public:
+		static constexpr size_t BucketCount = 64;
+
+	public:
+		uint64_t Samples;
+		uint64_t Total; // Nanoseconds.
+		uint64_t Max; // Nanoseconds.
+		std::array<uint32_t, BucketCount> Buckets;
+
+	public:
+		FunctionTiming();
+		~FunctionTiming();
+
+	public:
+		void Add(uint64_t nanoseconds, uint32_t weight = 1);
+		uint64_t GetAverage() const;
+		uint64_t GetPercentile(double percentile) const;
+		static void FormatTime(char* buffer, size_t bufferSize, uint64_t nanoseconds);
+
+	private:
+		static size_t GetBucket(uint64_t nanoseconds);
+		static uint64_t GetBucketLimit(size_t bucket);
+	};
+
+	// Aggregated Package -> Caller -> Function tree, every edge is found through a single hash lookup keyed by its parent node and child name.
+	class CallGraph
+	{
+	public:
+		static constexpr uint32_t RootNode = 0;
+
+	public:
+		struct Node
+		{
+			uint32_t Name; // ID in "FunctionData::ObjectNames".
+			uint32_t Depth; // 1 for packages, 2 for callers, 3 for functions.
+			uint64_t Calls;
+			std::vector<uint32_t> Children;
+		};
+
+	private:
+		struct Edge
+		{
+			uint64_t Key; // Parent node shifted left by 32 or'd with the child's name.
+			uint32_t Child; // "RootNode" if the bucket is empty, the root is never anyone's child.
+		};
+
+	private:
+		std::vector<Node> Nodes;
+		std::vector<Edge> Edges; // Open addressing with linear probing, kept at most half full like "IndexMap".
+		size_t EdgeMask;
+
+	public:
+		CallGraph();
+		~CallGraph();
+
+	public:
+		void Add(uint32_t package, uint32_t caller, uint32_t function, uint64_t calls = 1);
+		const Node& GetNode(uint32_t node) const;
+		void SortChildren(uint32_t node); // Most called first, only done for nodes that are actually open in the tree view.
+		const std::vector<Node>& GetNodes() const;
+		size_t Size() const;
+		static void WriteFolded(const std::vector<Node>& nodes, const std::vector<std::string_view>& names, std::string& out); // One "Package;Caller;Function count" line per leaf, the folded stack format flamegraph tools read. "names" are views of "FunctionData::ObjectNames" by ID.
+		void Clear();
+
+	private:
+		uint32_t GetChild(uint32_t parent, uint32_t name, uint64_t calls);
+		static size_t Hash(uint64_t key);
+		void Rehash(size_t bucketCount);
+	};
+
+	// Raw per-function state behind the duplicate table's columns, copied on the render thread so the export thread works out averages, percentiles, and rates itself.
+	struct ExportStats
+	{
+		uint64_t Calls;
+		FunctionRate Rate;
+		FunctionTiming Timing; // No samples if the function wasn't timed.
+	};
+
+	// Formats a snapshot of table rows on a background thread into fixed-size chunks, either streamed to a file or joined for the clipboard once done.
+	class TableExporter
+	{
+	public:
+		static constexpr size_t ChunkBytes = (1024 * 1024);
+
+	private:
+		std::thread Thread;
+		std::atomic<bool> Running;
+		std::atomic<bool> Cancelled;
+		std::atomic<size_t> RowsWritten;
+		ExportFormats Format;
+		std::string FilePath;
+		bool HistoryTable; // Rows come from "History" by "HistoryIds" instead of "Rows".
+		std::vector<FunctionData> Rows;
+		std::vector<ExportStats> Stats; // Parallel to "Rows", empty for the clipboard since it only takes full names.
+		uint64_t NowSecond; // What "Stats" rates are measured up to.
+		std::array<uint32_t, 3> RateWindows; // Seconds each rate column averages over.
+		std::vector<SharedRecords> History; // Every retained block as of the export, kept alive here even if the store evicts or rewrites it.
+		std::vector<uint64_t> HistoryIds;
+		uint64_t HistoryFirstId; // ID of the first record in "History".
+		std::vector<CallGraph::Node> GraphNodes; // Copied for "ExportFormats::Flamegraph", the edges aren't needed to fold it.
+		std::vector<std::string_view> FullNames; // Views into "FunctionData::FullNames", whose strings never move until it's cleared.
+		std::vector<std::string_view> ObjectNames;
+		std::string ClipboardText; // Written by the export thread, only read once it has been joined.
+		bool Failed;
+
+	public:
+		TableExporter();
+		~TableExporter();
+
+	public:
+		bool Start(ExportFormats format, const std::string& filePath, std::vector<FunctionData>&& rows, std::vector<ExportStats>&& stats, uint64_t nowSecond, const std::array<uint32_t, 3>& rateWindows); // The duplicate table. Returns false if an export is already running.
+		bool Start(ExportFormats format, const std::string& filePath, std::vector<SharedRecords>&& history, std::vector<uint64_t>&& ids, uint64_t firstId); // The history table, "ids" are looked up in "history" on the export thread.
+		bool Start(const std::string& filePath, std::vector<CallGraph::Node>&& graph); // Folded stacks of the call graph.
+		void Cancel(); // Blocks until the export thread has stopped, partial files are deleted.
+		bool IsRunning() const;
+		size_t GetRowsWritten() const;
+		size_t GetRowCount() const;
+		ExportFormats GetFormat() const;
+		const std::string& GetFilePath() const;
+		bool Finish(std::string& clipboardText); // Call every frame, returns true once when a finished export has clipboard text to hand over.
+
+	private:
+		bool Launch(ExportFormats format, const std::string& filePath);
+		void ExportThread();
+		const FunctionData& GetRow(size_t row) const;
+		void WriteHeader(std::string& chunk) const;
+		void WriteRow(std::string& chunk, size_t row) const;
+		static void WriteText(std::string& chunk, std::string_view text, ExportFormats format);
+		static void WriteNumber(std::string& chunk, uint64_t value);
+		static void WriteNumber(std::string& chunk, float value);
+	};
+
+	// Calls per frame with a min/max pyramid on top, level "n" summarizes 2^n frames per entry so a zoomed out view only ever reads about one entry per pixel.
+	class FrameTimeline
+	{
+	public:
+		static constexpr size_t MaxFrames = (1 << 22); // Oldest half is dropped past this, a little over 19 hours at 60 fps.
+
+	public:
+		struct Range
+		{
+			uint32_t Min;
+			uint32_t Max;
+		};
+
+	private:
+		uint32_t FirstFrame; // Frame number of "Calls[0]".
+		std::vector<uint32_t> Calls; // Level zero, frames without any accepted events are zero.
+		std::vector<std::vector<Range>> Levels; // "Levels[n - 1]" is level "n", each entry covers two entries of the level below.
+		size_t DirtyFrom; // First offset in "Calls" that changed since the pyramid was last rebuilt.
+
+	public:
+		FrameTimeline();
+		~FrameTimeline();
+
+	public:
+		void Add(uint32_t frame, uint32_t calls = 1);
+		void Update(); // Rebuilds the pyramid above whatever changed, normally just the last few frames.
+		size_t GetLevelCount() const;
+		size_t GetLevelSize(size_t level) const;
+		Range Get(size_t level, size_t entry) const;
+		uint32_t GetFirstFrame() const;
+		size_t GetFrameCount() const;
+		size_t GetBytes() const;
+		void Clear();
+	};
+
+	// Bounded multi-producer/single-consumer ring, producers only claim and write a single slot and never wait on the consumer.
+	template <typename T>
+	class EventRing
+	{
+	private:
+		struct Slot
+		{
+			std::atomic<size_t> Sequence;
+			T Data;
+		};
+
+	private:
+		std::unique_ptr<Slot[]> Slots;
+		size_t Mask;
+		alignas(64) std::atomic<size_t> EnqueuePos; // Shared between producers, kept on its own cache line.
+		alignas(64) size_t DequeuePos; // Only ever touched by the consumer.
+		std::atomic<size_t> Dropped; // Events rejected because the ring was full.
+
+	public:
+		EventRing() : Mask(0), EnqueuePos(0), DequeuePos(0), Dropped(0) {}
+		explicit EventRing(size_t capacity) : EventRing() { Reserve(capacity); } // For rings that producers can reach before anything else could reserve them.
+		~EventRing() {}
+
+	public:
+		// Capacity is rounded up to a power of two, must not be called while producers are pushing.
+		void Reserve(size_t capacity)
+		{
+			size_t powerOfTwo = 2;
+			while (powerOfTwo < capacity) { powerOfTwo <<= 1; }
+
+			Slots = std::make_unique<Slot[]>(powerOfTwo);
+			Mask = (powerOfTwo - 1);
+
+			for (size_t i = 0; i < powerOfTwo; i++)
+			{
+				Slots[i].Sequence.store(i, std::memory_order_relaxed);
+			}
+
+			EnqueuePos.store(0, std::memory_order_relaxed);
+			DequeuePos = 0;
+			Dropped.store(0, std::memory_order_relaxed);
+		}
+
+		size_t GetCapacity() const
+		{
+			return (Slots ? (Mask + 1) : 0);
+		}
+
+		size_t GetDropped() const
+		{
+			return Dropped.load(std::memory_order_relaxed);
+		}
+
+		void ResetDropped()
+		{
+			Dropped.store(0, std::memory_order_relaxed);
+		}
+
+		// Safe to call from any thread, returns false (and counts a drop) if the ring is full.
+		bool Push(const T& data)
+		{
+			if (!Slots)
+			{
+				return false;
+			}
+
+			Slot* slot = nullptr;
+			size_t position = EnqueuePos.load(std::memory_order_relaxed);
+
+			while (true)
+			{
+				slot = &Slots[position & Mask];
+				intptr_t difference = (static_cast<intptr_t>(slot->Sequence.load(std::memory_order_acquire)) - static_cast<intptr_t>(position));
+
+				if (difference == 0)
+				{
+					if (EnqueuePos.compare_exchange_weak(position, (position + 1), std::memory_order_relaxed))
+					{
+						break;
+					}
+				}
+				else if (difference < 0)
+				{
+					Dropped.fetch_add(1, std::memory_order_relaxed);
+					return false;
+				}
+				else
+				{
+					position = EnqueuePos.load(std::memory_order_relaxed);
+				}
+			}
+
+			slot->Data = data;
+			slot->Sequence.store((position + 1), std::memory_order_release);
+			return true;
+		}
+
+		// Consumer only, returns false once there are no completed slots left.
+		bool Pop(T& data)
+		{
+			if (!Slots)
+			{
+				return false;
+			}
+
+			Slot& slot = Slots[DequeuePos & Mask];
+
+			if ((static_cast<intptr_t>(slot.Sequence.load(std::memory_order_acquire)) - static_cast<intptr_t>(DequeuePos + 1)) < 0)
+			{
+				return false;
+			}
+
+			data = std::move(slot.Data);
+			slot.Sequence.store((DequeuePos + Mask + 1), std::memory_order_release);
+			DequeuePos++;
+			return true;
+		}
+
+		// Consumer only, pops at most "maxCount" entries so a producer flood can't stall the caller indefinitely.
+		template <typename Fn>
+		size_t Drain(Fn&& callback, size_t maxCount)
+		{
+			T data;
+			size_t drained = 0;
+
+			while ((drained < maxCount) && Pop(data))
+			{
+				callback(data);
+				drained++;
+			}
+
+			return drained;
+		}
+	};
+
+	// Single-threaded FIFO that overwrites its oldest entry once full, so appending and evicting are O(1) and entries never move once written.
+	// Every entry also gets an ID that keeps counting up across evictions, what indices into the ring can be kept as.
+	template <typename T>
+	class RingBuffer
+	{
+	private:
+		std::vector<T> Entries; // Grows up to "Capacity", then wraps around.
+		size_t Head; // Slot of the oldest entry.
+		size_t Capacity;
+		uint64_t EndId; // ID the next entry will get.
+
+	public:
+		RingBuffer() : Head(0), Capacity(0), EndId(0) {}
+		~RingBuffer() {}
+
+	public:
+		uint64_t Push(const T& data)
+		{
+			if (Entries.size() < Capacity)
+			{
+				Entries.push_back(data);
+			}
+			else if (Capacity > 0)
+			{
+				Entries[Head] = data;
+				Head = (((Head + 1) == Entries.size()) ? 0 : (Head + 1));
+			}
+
+			return EndId++;
+		}
+
+		// Zero is the oldest entry.
+		T& operator[](size_t position)
+		{
+			position += Head;
+			return Entries[(position >= Entries.size()) ? (position - Entries.size()) : position];
+		}
+
+		const T& operator[](size_t position) const
+		{
+			position += Head;
+			return Entries[(position >= Entries.size()) ? (position - Entries.size()) : position];
+		}
+
+		bool Empty() const
+		{
+			return Entries.empty();
+		}
+
+		size_t Size() const
+		{
+			return Entries.size();
+		}
+
+		size_t GetCapacity() const
+		{
+			return Capacity;
+		}
+
+		uint64_t GetFirstId() const
+		{
+			return (EndId - Entries.size());
+		}
+
+		uint64_t GetEndId() const
+		{
+			return EndId;
+		}
+
+		// Keeps the newest entries that still fit, their IDs stay the same.
+		void SetCapacity(size_t capacity)
+		{
+			std::vector<T> entries;
+			size_t keep = std::min(Entries.size(), capacity);
+			entries.reserve(keep);
+
+			for (size_t i = (Entries.size() - keep); i < Entries.size(); i++)
+			{
+				entries.push_back((*this)[i]);
+			}
+
+			Entries = std::move(entries);
+			Head = 0;
+			Capacity = capacity;
+		}
+
+		// IDs keep counting, so anything still holding one can tell its entry is gone.
+		void Clear()
+		{
+			Entries.clear();
+			Head = 0;
+		}
+	};
+
+	// Running sum of wrapped line heights keyed by ring ID, lines are appended at the back and trimmed from the front as the ring evicts them.
+	// Finding the line at a scroll offset is a binary search, finding where a line starts is a lookup.
+	class LineLayout
+	{
+	private:
+		std::deque<double> Bottoms; // Where line "FirstId + i" ends, relative to where the layout was last reset.
+		double Base; // Bottom of the last line trimmed off the front, where the first line starts.
+		uint64_t FirstId;
+
+	public:
+		LineLayout();
+		~LineLayout();
+
+	public:
+		void Reset(uint64_t firstId);
+		void Append(float height);
+		void Trim(uint64_t firstId); // Drops every line before "firstId".
+		uint64_t GetFirstId() const;
+		uint64_t GetEndId() const;
+		float GetTop(uint64_t id) const;
+		float GetHeight() const;
+		uint64_t FindLine(float offset) const; // Line that covers "offset", "GetEndId" if it's past the last one.
+	};
+
+	// Append-only log of styled lines, the text is packed back to back into fixed-size blocks and each line is just a small record pointing into them.
+	// Lines are evicted oldest first by the ring, so a block goes back to the spare list as soon as the last line in it is gone.
+	class TextLog
+	{
+	public:
+		static constexpr size_t BlockBytes = (64 * 1024); // Longer lines are cut to fit.
+		static constexpr size_t MaxSpareBlocks = 2;
+
+	public:
+		struct LineRecord
+		{
+			uint64_t Offset; // Position of the first byte in the log, never reused so the block is just "Offset / BlockBytes".
+			uint32_t Length; // Not counting the null terminator stored after it.
+			uint8_t Palette; // "TextColors" value, resolved through "ImColorMap" when drawn.
+			TextStyles Style;
+		};
+
+	private:
+		RingBuffer<LineRecord> Lines;
+		std::deque<std::unique_ptr<char[]>> Blocks;
+		std::vector<std::unique_ptr<char[]>> SpareBlocks;
+		uint64_t FirstBlock; // Block number of "Blocks.front()".
+		uint64_t EndOffset; // Where the next line will be written.
+
+	public:
+		TextLog();
+		~TextLog();
+
+	public:
+		uint64_t Push(const std::string& text, TextColors textColor, TextStyles textStyle); // Returns the line's ID.
+		const LineRecord& operator[](size_t position) const; // Zero is the oldest line.
+		const char* GetText(const LineRecord& line) const; // Null terminated.
+		ImVec4 GetColor(const LineRecord& line) const;
+		size_t Size() const;
+		uint64_t GetFirstId() const;
+		uint64_t GetEndId() const;
+		size_t GetBytes() const;
+		void SetCapacity(size_t lineCount);
+		void Clear(); // Line IDs keep counting, same as "RingBuffer::Clear".
+
+	private:
+		void ReleaseBlocks(); // Recycles every block before the one holding the oldest line.
+	};
+
+	// Completion words sorted case-insensitively, a prefix lookup is two binary searches and a fuzzy lookup ranks subsequence matches into a bounded top list.
+	// Adding only appends, the sort happens on the next lookup so registering thousands of words up front stays cheap.
+	class CompletionIndex
+	{
+	private:
+		static constexpr size_t KeyPadding = 16; // Widest load "FindChar" makes.
+		static constexpr size_t SlotCount = 42; // 'a' to 'z', '0' to '9', then the separators "IsWordStart" knows about.
+		static constexpr size_t OccurrenceCount = 4; // Position columns per slot, the first three times a character appears in a word and then the last.
+		static constexpr size_t LastOccurrence = (OccurrenceCount - 1);
+		static constexpr uint8_t NoPosition = UINT8_MAX;
+		static constexpr uint8_t FarPosition = 0x7F; // Seen at least this far in, "FindChar" finds the exact spot.
+		static constexpr uint8_t WordStartFlag = 0x80; // Set on a position column entry if that position starts a part of the word, never set with "FarPosition".
+		static constexpr uint32_t LaneCount = 16; // Words per SSE2 step, every per-word column is padded to a multiple of this.
+		static constexpr uint8_t NoMatch = 0;
+		static constexpr int32_t MaxPosition = (UINT8_MAX - 1); // Fuzzy matching only looks this far into a word, so a position fits a byte and a whole pattern's score fits 16 bits.
+		static constexpr size_t PrefetchDistance = 8; // Deferred words ahead of the one being matched whose keys are already being fetched.
+
+	private:
+		// A word the columns couldn't settle, matched against its key once the SIMD pass over its level is done.
+		struct DeferredWord
+		{
+			uint32_t Index;
+			uint32_t From; // Where it is in the previous level.
+			uint32_t To; // Where it goes in this one.
+		};
+
+		// Greedy match state for one pattern prefix, kept as columns so each keystroke is a SIMD pass instead of a list of matches to score and store.
+		// Only blocks with a match are kept, one after the other, so a level shrinks with its matches and the next one reads it front to back.
+		struct MatchLevel
+		{
+			std::vector<uint32_t> Blocks; // Groups of "LaneCount" words with at least one match, in order.
+			std::vector<uint8_t> Positions; // "LaneCount" per entry of "Blocks", one past where the level's character matched or "NoMatch" if the word doesn't.
+			std::vector<uint16_t> Scores; // Same layout, exact since no word matches more than "MaxPosition" characters.
+			std::vector<DeferredWord> Deferred; // Only used while the level is being matched, kept to reuse its memory.
+			const uint8_t* Column; // The first level isn't stored if its character has a slot, the next one works it out from that slot's first occurrences instead.
+			char Character;
+			size_t Count; // Words that match.
+		};
+
+		// Best matches ranked so far, a heap with the worst of them at the front so a word that can't beat it is skipped without leaving SIMD.
+		// Words the columns settle are offered in index order, so one that only ties the worst kept word never gets in. Deferred words come later and always go through "Offer".
+		struct TopMatches
+		{
+			std::vector<std::pair<int32_t, uint32_t>> Best; // Score times 64 plus how close the word's length is to the pattern's, then the word.
+			size_t MaxResults;
+			size_t PatternLength;
+			uint16_t WorstScore; // Score of "Best.front()" once it's full.
+			uint8_t LengthLimit; // Longest a word with "WorstScore" can be and still get in, lengths saturate so a long word always goes through "Offer".
+		};
+
+	private:
+		std::vector<std::string> Words; // Sorted by their keys unless "Dirty".
+		std::string KeyPool; // Lowercase copy of every word back to back, each null terminated and the pool padded so vector loads never read past the end.
+		std::vector<uint8_t> WordStarts; // Same layout as "KeyPool", set where a word starts a new part (after a separator or a lower to upper case change) so scoring never touches "Words".
+		std::vector<uint32_t> KeyOffsets; // Where each word's key starts in "KeyPool", one extra entry marks the end.
+		std::vector<uint8_t> KeyLengths; // Saturated at "UINT8_MAX" and padded like "Occurrences", read by the ranking pass.
+		std::array<std::vector<uint8_t>, (SlotCount * OccurrenceCount)> Occurrences; // Per letter, digit, or separator and per "OccurrenceCount", where it appears in each word. Matching a pattern character is a pass over these instead of the words.
+		bool Dirty;
+		std::string LastPattern;
+		std::vector<MatchLevel> LastMatches; // "LastMatches[i]" is the state after the first "i + 1" characters of "LastPattern", typing or deleting at the end only redoes what changed.
+		size_t MatchedLevels; // How many of "LastMatches" are still valid.
+
+	public:
+		CompletionIndex();
+		~CompletionIndex();
+
+	public:
+		void Add(const std::string& word);
+		bool Remove(const std::string& word); // First exact match only.
+		void Clear();
+		size_t Size() const;
+		size_t GetBytes() const;
+		size_t FindPrefix(const char* prefix, size_t length, size_t maxResults, std::vector<const std::string*>& results); // Alphabetical, returns how many words match in total. Pointers are valid until the next "Add", "Remove", or "Clear".
+		size_t FindFuzzy(const char* pattern, size_t length, size_t maxResults, std::vector<const std::string*>& results); // Best match first, shorter words then alphabetical order break ties. Returns how many words match in total, only the first "MaxPosition" characters of a word are matched.
+
+	private:
+		void Sort();
+		void Match(char c, const MatchLevel* previous, MatchLevel& level, TopMatches* top) const; // Every word for the first level, only the blocks "previous" matched in after that. Ranks each block into "top" while it's still in cache if given.
+		void Offer(int32_t score, uint32_t index, TopMatches& top) const;
+		uint32_t GetPaddedSize() const;
+		const uint8_t* GetOccurrences(size_t slot, size_t occurrence) const;
+		const char* GetKey(uint32_t index) const;
+		uint32_t GetKeyLength(uint32_t index) const;
+		static size_t GetSlot(char c); // "SlotCount" if "c" isn't a lowercase letter, digit, or separator.
+		static bool IsWordStart(const std::string& word, size_t position);
+		static bool IsBetter(const std::pair<int32_t, uint32_t>& left, const std::pair<int32_t, uint32_t>& right); // Words are ranked in index order, so ties go to whichever comes first.
+		static uint32_t GetLowestBit(uint32_t bits);
+		static uint32_t GetLaneCount(uint32_t lanes); // Set bits in a mask of "LaneCount" lanes.
+		static int32_t FindChar(const char* key, uint32_t from, uint32_t length, char c); // Position of "c" in "[from, length)", or negative.
+		int32_t GetStepScore(uint32_t index, int32_t previous, int32_t position) const; // Greedy, consecutive runs and word starts score higher, gaps cost a little.
+	};
 }
 
 // Base class for all ImGui interfaces, controls attaching/detaching as well as rendering.
@@ -233,14 +1336,72 @@ public:
 class ImFunctionScanner : public ImInterface
 {
 private:
-	std::string ClipboardText;
 	ImGuiTableFlags TableFlags;
 	ImGuiTextFilter Whitelist;
 	ImGuiTextFilter Blacklist;
-	std::vector<ImClasses::FunctionData> FunctionHistory;
-	std::vector<std::pair<int32_t, ImClasses::FunctionData>> FunctionMap;
-	static inline bool ScanFunctions;
+	ImClasses::TextMatcher FilterMatcher; // "Whitelist" and "Blacklist" compiled together, rebuilt in "OnFilterChanged".
+	ImClasses::HistoryStore FunctionHistory;
+	std::vector<ImClasses::FunctionCount> FunctionMap; // Distinct functions in first-seen order.
+	std::vector<ImClasses::FunctionTiming> FunctionTimings; // Parallel to "FunctionMap", only grown once timed events arrive.
+	std::vector<ImClasses::FunctionRate> FunctionRates; // Parallel to "FunctionMap".
+	ImClasses::IndexMap FunctionSlots; // Function index to its row in "FunctionMap".
+	std::deque<uint64_t> HistoryRows; // IDs in "FunctionHistory" that pass the filters, what the default table clips over. Trimmed from the front as blocks are evicted.
+	std::vector<uint32_t> FunctionRows; // Rows of "FunctionMap" that pass the filters, what the duplicate table clips over.
+	uint64_t HistoryScanned; // ID of the first event in "FunctionHistory" that hasn't been checked against the filters yet.
+	size_t FunctionsScanned; // How many rows of "FunctionMap" have been checked against the filters so far.
+	ImClasses::IndexMap VerdictSlots; // Function index to its entry in "FilterVerdicts".
+	std::vector<uint32_t> FilterVerdicts; // Cached filter result per distinct function, the generation it was computed in shifted left by one and the verdict in the low bit.
+	uint32_t FilterGeneration; // Bumped whenever the whitelist or blacklist text changes, stale verdicts are recomputed on their next lookup.
+	ImClasses::FilterBits CaptureVerdicts; // Mirrors "FilterVerdicts" by function index so "OnProcessEvent" can drop rejected functions with a single bit test.
+	ImClasses::EventRing<ImClasses::FunctionEvent> EventQueue; // Written to by "OnProcessEvent" from the game thread, drained once per frame in "OnRender".
+	size_t DroppedSnapshot; // Ring drop counter as of the last drain.
+	size_t DroppedLastFrame; // Events lost between the last two drains.
+	ImClasses::CaptureWriter FileWriter; // Used by "SaveToFile" for one-shot saves.
+	ImClasses::CaptureWriter DiskRecorder; // Streams every accepted event while "RecordToDisk" is enabled.
+	ImClasses::TableExporter Exporter; // CSV, JSON lines, and clipboard exports of whichever table is shown.
+	uint64_t CaptureNanoseconds; // Time spent scanning, what call rates for the diff and saved captures are averaged over. Stretches spent stopped don't count.
+	uint64_t CaptureResumed; // "EventClock" tick the current scanning stretch was last counted up to, zero while stopped.
+	ImClasses::CaptureFile Baseline;
+	std::unordered_map<std::string_view, uint32_t> BaselineRows; // Full name to its row in "Baseline", the build side of the diff's hash join. Views point into the mapped file.
+	std::vector<uint32_t> BaselineMatches; // Parallel to "FunctionMap", the probe result for each live function so it's only ever looked up once.
+	std::vector<ImClasses::FunctionDiff> DiffRows;
+	uint64_t DiffSecond; // Rates move every second, so the diff is rebuilt at most once per second unless something else changed.
+	bool DiffDirty;
+	bool ShowBaselineDiff;
+	bool DiffChangesOnly; // Hide functions whose rate stayed within "DiffThreshold".
+	bool BaselineFailed; // Last "LoadBaseline" call couldn't open or validate the file.
+	float DiffThreshold; // Percent change in call rate before a function counts as changed.
+	char BaselinePath[260];
+	bool RecordToDisk;
+	size_t SortedRows; // Leading rows of "FunctionRows" that are in sorted order, anything past this was appended since the last sort.
+	std::vector<uint32_t> ChangedSlots; // Rows of "FunctionMap" whose stats changed since the last sort.
+	std::vector<uint8_t> ChangedFlags; // Parallel to "FunctionMap", set while a row is in "ChangedSlots".
+	std::vector<uint32_t> RowPositions; // Parallel to "FunctionMap", where each row was in "FunctionRows" after the last sort. Checked before use since filtering rebuilds the rows.
+	uint64_t SortedSecond; // Rate columns shift every second even without new events.
+	std::array<int32_t, 3> RateWindows; // Seconds each rate column averages over, 1 to "FunctionRate::HistorySeconds" since that's all the buckets hold.
+	ImClasses::CallGraph FunctionGraph; // Every accepted event, grouped by package then caller then function.
+	ImClasses::FrameTimeline FrameCalls; // Accepted calls per frame, what the timeline draws.
+	double TimelineStart; // First frame in view.
+	double TimelineSpan; // Frames in view, zero to fit everything captured so far.
+	uint32_t FrameFilterBegin; // First frame the history table is limited to.
+	uint32_t FrameFilterEnd; // One past the last frame, zero if the history table isn't limited to a frame range.
+	std::unique_ptr<ImClasses::TokenBucket[]> TokenBuckets; // Hashed by "UFunction" address, each one owned by a single function so budgets and skipped counts are never shared.
+	std::mt19937 ReservoirRandom;
+	uint64_t ReservoirSeen; // Events offered to the history reservoir since it was last cleared.
+	int32_t ReservoirSize;
+	int32_t HistoryCapMegabytes;
+	static constexpr size_t TokenBucketCount = 16384;
+	static constexpr size_t TokenBucketProbes = 4; // Buckets tried past the hashed one before a function is captured without a budget.
+	static constexpr size_t MaxFilterIndex = (1 << 22); // Function indices covered by "CaptureVerdicts", 1 MB worth of bits.
+	static inline std::atomic<bool> ScanFunctions;
+	static inline std::atomic<bool> TimeFunctions;
+	static inline std::atomic<CapturePolicies> CapturePolicy;
+	static inline std::atomic<uint32_t> SampleInterval; // "N" for "CapturePolicies::OneInN".
+	static inline std::atomic<uint32_t> TokenRate; // Events per second per function for "CapturePolicies::TokenBucket".
+	static inline std::atomic<uint32_t> FrameCounter; // Bumped once per "OnRender", every captured event is tagged with its value.
 	static inline bool HideDuplicates;
+	static inline bool ShowCallGraph;
+	static inline bool ShowTimeline;
 
 public:
 	ImFunctionScanner(const std::string& title, const std::string& name, std::function<void(std::string, bool)> toggleCallback, bool bShowCursor = true);
@@ -254,9 +1415,47 @@ public:
 public:
 	static bool IsScanning();
 	void SaveToFile();
+	void ExportTable(ExportFormats format, bool bFunctionTable);
+	void ExportFlamegraph();
+	bool LoadBaseline(const std::string& filePath);
+	void ClearBaseline();
+	uint64_t GetSessionDuration() const;
+	void UpdateBaselineDiff(const ImGuiTableSortSpecs* sortSpecs);
+	void RenderBaselineDiff();
+	void StartRecording();
+	void StopRecording();
 	void ClearTable();
-	bool PassesFilter(const std::string& textToFilter);
-	void OnProcessEvent(class UObject* caller, class UFunction* function); // Here is where you could send ProcessEvent to from your game.
+	bool PassesFilter(std::string_view textToFilter);
+	bool PassesFilter(const ImClasses::FunctionData& functionData);
+	void OnFilterChanged();
+	void InvalidateRows();
+	void TrimHistoryRows();
+	void PatchHistoryRow(uint64_t id); // For an event overwritten in place, adds or removes just its row.
+	void UpdateRows();
+	void MarkFunctionChanged(uint32_t slot);
+	bool IsSortedByStats(const ImGuiTableSortSpecs* sortSpecs) const;
+	bool FunctionRowLess(const ImGuiTableSortSpecs* sortSpecs, uint64_t nowSecond, uint32_t left, uint32_t right) const;
+	void SortFunctionRows(const ImGuiTableSortSpecs* sortSpecs, bool bFullSort);
+	size_t FindSortedPosition(const ImGuiTableSortSpecs* sortSpecs, uint64_t nowSecond, uint32_t slot) const; // Where "slot" belongs among the rows that aren't flagged in "ChangedFlags".
+	static uint64_t GetCurrentSecond();
+	void RenderCallGraph(uint32_t node);
+	void RenderTimeline();
+	void SetFrameFilter(uint32_t firstFrame, uint32_t endFrame); // Limits the history table to "[firstFrame, endFrame)", an empty range clears it.
+	bool PassesFrameFilter(const ImClasses::FunctionData& functionData) const;
+	void SetFilters(const std::string& whitelist, const std::string& blacklist);
+	size_t GetMemoryUsage() const; // Bytes held by the history, name tables, and per-function stats.
+	void UpdateCaptureTime(); // Once per frame, adds the time since the last call if scanning was on.
+	void DrainEvents();
+	void AddEvent(const ImClasses::FunctionData& newEntry, uint64_t duration, uint32_t weight, bool bRecording); // Counts an event that already passed the filters.
+	size_t GetReservoirCapacity(size_t memoryCap) const; // Smaller of "ReservoirSize" and what the memory cap holds, so the cap never has to evict part of the sample.
+	void TrimReservoir(size_t capacity); // Keeps a uniform subset of the history in its original order.
+	void AddToHistory(const ImClasses::FunctionData& functionData);
+	uint32_t SampleEvent(class UFunction* function, uint64_t nowTicks);
+	static int32_t GetFunctionIndex(class UFunction* function);
+	static int32_t GetObjectIndex(class UObject* object);
+	static uint32_t GetObjectGeneration(class UObject* object);
+	uint64_t OnProcessEventBegin(); // Call right before the original ProcessEvent and pass the result to "OnProcessEvent" to time the call, returns zero when timing is off.
+	void OnProcessEvent(class UObject* caller, class UFunction* function, uint64_t beginTicks = 0); // Here is where you could send ProcessEvent to from your game (after calling the original), safe to call from any thread.
 };
 
 class ImTerminal : public ImInterface
@@ -264,11 +1463,17 @@ class ImTerminal : public ImInterface
 private:
 	static inline size_t MaxUserHistory;
 	static inline size_t MaxConsoleHistory;
-	static inline std::vector<ImClasses::TextData> ConsoleText;
-	static inline std::vector<ImClasses::QueueData> ConsoleQueue;
+	static inline ImClasses::TextLog ConsoleText; // Holds the last "MaxConsoleHistory" lines.
+	static inline ImClasses::EventRing<ImClasses::QueueData> ConsoleQueue{ 8192 }; // Written to by "AddDisplayText" from any thread, drained into "ConsoleText" at the start of "OnRender".
+	static inline size_t DroppedSnapshot; // Queue drop counter as of the last drain.
+	static inline size_t DroppedLastFrame; // Lines lost between the last two drains.
+	static inline size_t PeakBacklog; // Most lines a single drain has had to move, how close logging has come to filling the queue.
 	static inline std::vector<std::string> UserHistory;
-	static inline std::vector<char*> CommandCompletes;
-	static inline std::map<ImArgumentIds, std::vector<std::string>> ArgumentCompletes;
+	static inline ImClasses::CompletionIndex CommandCompletes;
+	static inline std::map<ImArgumentIds, ImClasses::CompletionIndex> ArgumentCompletes;
+
+public:
+	static constexpr size_t MaxCandidates = 64; // Most candidates shown at once, the popup notes how many more there are.
 
 private:
 	char InputBuffer[512];
@@ -278,6 +1483,15 @@ private:
 	int32_t CandidatePos;
 	ImArgumentIds ArgumentType;
 	std::vector<std::pair<std::string, bool>> Candidates;
+	size_t CandidateTotal; // Every word that matched, "Candidates" only holds the first "MaxCandidates" of them.
+	bool FuzzyComplete; // Rank subsequence matches instead of listing prefix matches alphabetically.
+	std::deque<uint64_t> FilteredLines; // IDs in "ConsoleText" that pass "Filter", what the terminal clips over. Trimmed from the front as the log evicts.
+	uint64_t FilteredEnd; // ID of the first line that hasn't been checked against the filter yet.
+	ImClasses::LineLayout ConsoleLayout; // Wrapped height of every line in "FilteredLines", keyed by how many matches came before it. Only re-measured when the layout key below changes.
+	float LayoutWidth;
+	float LayoutIndent; // Where lines start inside the scroll region.
+	float LayoutFontSize;
+	ImFont* LayoutFont;
 	bool AutoScroll;
 	bool ScrollToBottom;
 
@@ -297,12 +1511,17 @@ public:
 	static void ClearCommands();
 	static void AddArgument(ImArgumentIds argumentId, const std::string& str);
 	static void RemoveArgument(ImArgumentIds argumentId, const std::string& str);
-	static void AddDisplayText(const std::string& text, TextColors textColor, TextStyles textStyle);
+	static void AddDisplayText(const std::string& text, TextColors textColor, TextStyles textStyle); // Safe to call from any thread, never blocks. Lines show up once the render thread drains them.
 	static void AddDisplayText(const ImClasses::QueueData& queueData);
 	static void ConsoleDelegate(const std::string& text, TextColors textColor, TextStyles textStyle);
+	static void DrainQueue(); // Render thread only.
 
 public:
 	void ExecuteCommand(const std::string& command, TextStyles textStyle = TextStyles::Regular);
 	void ResetAutoComplete();
+	void FindCandidates(ImClasses::CompletionIndex& completes, const char* word, size_t length); // Fills "Candidates" from "completes" using whichever mode "FuzzyComplete" picks.
+	void InvalidateLines();
+	void UpdateLines();
+	float GetLineHeight(const ImClasses::TextLog::LineRecord& line) const;
 	int32_t TextEditCallback(struct ImGuiInputTextCallbackData* data);
 };
\ No newline at end of file
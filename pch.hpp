@@ -16,4 +16,22 @@
 #include <thread>
 #include <string>
 #include <cmath>
-#include <filesystem>
\ No newline at end of file
+#include <filesystem>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include <deque>
+#include <string_view>
+#include <mutex>
+#include <condition_variable>
+#include <array>
+#include <random>
+#include <tuple>
+#include <charconv>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
\ No newline at end of file